@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""
+Save sstr_bench results as a baseline and check later runs against it
+
+Usage:
+    bench_compare.py save RESULTS BASELINE
+    bench_compare.py check RESULTS BASELINE [--threshold FRACTION]
+                                            [--ns-threshold FRACTION]
+                                            [--operations OP,OP...]
+
+Each operation's sizes are grouped into size classes. For every sstr
+command the baseline records the geometric mean ns/op over each class and
+its ratio to the libc command of the same operation, timed in the same run.
+check fails when a ratio grows by more than the threshold for one of the
+gated operations. Ratios are compared rather than raw times so a baseline
+stays meaningful on a machine of a different speed; --ns-threshold also
+gates the raw ns/op, for runs on the machine that saved the baseline.
+"""
+
+import argparse
+import json
+import math
+import sys
+
+# Upper bound of each size class in bytes
+SIZE_CLASSES = [('small', 64), ('medium', 4096), ('large', 64 * 1024)]
+
+DEFAULT_OPERATIONS = 'copy,copy_n,append,format'
+DEFAULT_THRESHOLD = 0.15
+
+
+def size_class(size):
+    """Name of the class a source size falls in"""
+    for name, limit in SIZE_CLASSES:
+        if size <= limit:
+            return name
+    return SIZE_CLASSES[-1][0]
+
+
+def geometric_mean(values):
+    return math.exp(sum(math.log(v) for v in values) / len(values))
+
+
+def summarize(filename):
+    """Map operation -> class -> sstr command -> {ns_per_op, ratio}"""
+    with open(filename, 'r') as f:
+        data = json.load(f)
+
+    if data.get('benchmark') != 'sstr_bench':
+        sys.exit(f"{filename}: not sstr_bench output")
+
+    # operation -> class -> command -> (impl, [ns/op, ...])
+    samples = {}
+    for result in data['results']:
+        if result['ns_per_op'] <= 0.0:
+            continue
+        classes = samples.setdefault(result['operation'], {})
+        commands = classes.setdefault(size_class(result['size']), {})
+        impl, times = commands.setdefault(result['command'], (result['impl'], []))
+        times.append(result['ns_per_op'])
+
+    summary = {}
+    for operation, classes in samples.items():
+        for name, commands in classes.items():
+            means = {command: (impl, geometric_mean(times))
+                     for command, (impl, times) in commands.items()}
+            # The first libc command is the reference for the operation
+            std = next((ns for impl, ns in means.values() if impl == 'std'), None)
+            for command, (impl, ns) in means.items():
+                if impl != 'sstr':
+                    continue
+                entry = {'ns_per_op': round(ns, 3)}
+                if std is not None:
+                    entry['ratio'] = round(ns / std, 4)
+                summary.setdefault(operation, {}).setdefault(name, {})[command] = entry
+
+    return summary
+
+
+def save(args):
+    summary = summarize(args.results)
+    baseline = {
+        'benchmark': 'sstr_bench_baseline',
+        'size_classes': {name: limit for name, limit in SIZE_CLASSES},
+        'operations': summary,
+    }
+    with open(args.baseline, 'w') as f:
+        json.dump(baseline, f, indent=2, sort_keys=True)
+        f.write('\n')
+    print(f"Baseline for {len(summary)} operations saved to {args.baseline}")
+    return 0
+
+
+def check(args):
+    try:
+        with open(args.baseline, 'r') as f:
+            baseline = json.load(f)['operations']
+    except FileNotFoundError:
+        sys.exit(f"{args.baseline}: no baseline; save one first with 'bench_compare.py save'")
+    current = summarize(args.results)
+    gated = [op for op in args.operations.split(',') if op]
+
+    failures = 0
+    print(f"{'operation':<12} {'class':<7} {'command':<26} "
+          f"{'base':>12} {'now':>12} {'change':>8}")
+    for operation in sorted(set(baseline) | set(current)):
+        for name, _ in SIZE_CLASSES:
+            old_commands = baseline.get(operation, {}).get(name, {})
+            new_commands = current.get(operation, {}).get(name, {})
+            for command in sorted(set(old_commands) | set(new_commands)):
+                old = old_commands.get(command)
+                new = new_commands.get(command)
+                is_gated = operation in gated
+                if old is None or new is None:
+                    if is_gated and new is None:
+                        print(f"{operation:<12} {name:<7} {command:<26} missing from results")
+                        failures += 1
+                    continue
+
+                status = ''
+                if 'ratio' in old and 'ratio' in new:
+                    base, now = old['ratio'], new['ratio']
+                    unit = 'x'
+                    if is_gated and now > base * (1.0 + args.threshold):
+                        status = '  REGRESSION (ratio to libc)'
+                else:
+                    base, now = old['ns_per_op'], new['ns_per_op']
+                    unit = 'ns'
+                if (is_gated and args.ns_threshold is not None and
+                        new['ns_per_op'] > old['ns_per_op'] * (1.0 + args.ns_threshold)):
+                    status += '  REGRESSION (ns/op)'
+                if status:
+                    failures += 1
+
+                change = (now / base - 1.0) * 100.0
+                print(f"{operation:<12} {name:<7} {command:<26} "
+                      f"{base:>10.3f}{unit:<2} {now:>10.3f}{unit:<2} {change:>+7.1f}%{status}")
+
+    if failures:
+        print(f"\n{failures} regression(s) over the {args.threshold:.0%} threshold "
+              f"for {', '.join(gated)}")
+        return 1
+
+    print(f"\nNo regressions over the {args.threshold:.0%} threshold for {', '.join(gated)}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    commands = parser.add_subparsers(dest='mode', required=True)
+
+    save_parser = commands.add_parser('save', help='write a baseline from sstr_bench results')
+    save_parser.add_argument('results', help='sstr_bench JSON output')
+    save_parser.add_argument('baseline', help='baseline file to write')
+    save_parser.set_defaults(run=save)
+
+    check_parser = commands.add_parser('check', help='compare sstr_bench results to a baseline')
+    check_parser.add_argument('results', help='sstr_bench JSON output')
+    check_parser.add_argument('baseline', help='baseline file from save')
+    check_parser.add_argument('--threshold', type=float, default=DEFAULT_THRESHOLD,
+                              help='allowed growth of the ratio to libc (default 0.15)')
+    check_parser.add_argument('--ns-threshold', type=float, default=None,
+                              help='also allow ns/op to grow at most this much')
+    check_parser.add_argument('--operations', default=DEFAULT_OPERATIONS,
+                              help=f'operations to gate (default {DEFAULT_OPERATIONS})')
+    check_parser.set_defaults(run=check)
+
+    args = parser.parse_args()
+    return args.run(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * Compares the default-policy entry points with the _ex variants.
+ *
+ * Usage: bench_policy [default|error|truncate] [append_string]
+ *
+ * "default" calls sstr_copy/sstr_append, whose policy is fixed at compile
+ * time; "error" and "truncate" pass the policy to sstr_copy_ex and
+ * sstr_append_ex at run time. The default path should be no slower.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/sstr/sstr.h"
+
+#define NUM_ITERATIONS 1000000
+#define BUFFER_SIZE 256
+
+int main(int argc, char *argv[]) {
+    const char *mode = "default";
+    char *base_string = "Hello, world!";
+    char *append_string = " This is a benchmark for truncation policy selection.";
+
+    if (argc > 1) {
+        mode = argv[1];
+    }
+    if (argc > 2) {
+        append_string = argv[2];
+    }
+
+    /* Read the policy from the command line so it is not a constant */
+    int use_default = strcmp(mode, "default") == 0;
+    SStrTruncationPolicy policy = strcmp(mode, "truncate") == 0 ? SSTR_TRUNCATE : SSTR_ERROR;
+
+    char buffer[BUFFER_SIZE];
+    SStr dest;
+    sstr_init(&dest, buffer, BUFFER_SIZE);
+
+    clock_t start = clock();
+    for (int i = 0; i < NUM_ITERATIONS; i++) {
+        if (use_default) {
+            sstr_copy(&dest, base_string);
+            sstr_append(&dest, append_string);
+        } else {
+            sstr_copy_ex(&dest, base_string, policy);
+            sstr_append_ex(&dest, append_string, policy);
+        }
+    }
+    clock_t end = clock();
+
+    double ns_per_iteration = (double)(end - start) * 1e9 / CLOCKS_PER_SEC / NUM_ITERATIONS;
+    printf("%s: %.1f ns per copy+append (%s)\n", mode, ns_per_iteration, dest.data);
+
+    return 0;
+}
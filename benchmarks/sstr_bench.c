@@ -0,0 +1,645 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * In-process microbenchmarks for SStr and the libc equivalents.
+ *
+ * Usage: sstr_bench [--filter TEXT[,TEXT...]] [--max-size BYTES] [--samples N] [--output FILE]
+ *
+ * Every operation is timed inside this process over a sweep of source sizes
+ * from 1 B to 64 KiB. Each sample times a batch of calls sized to run for
+ * about BENCH_BATCH_NS, so timer overhead is negligible. Results are written
+ * as JSON with the median ns/op, bytes per cycle (medians, where a cycle
+ * counter is available; rdtsc counts reference cycles) and percentiles over
+ * the samples. The "results" entries also carry the
+ * hyperfine-style mean/stddev/min/max fields, in seconds per operation.
+ * The append_int cases append "Value: " and the size itself as an integer,
+ * comparing sstr_append_i64 with the "Value: %d" format path.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/sstr/sstr.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLES 1
+#define BENCH_COUNTER "rdtsc"
+#else
+#define BENCH_HAS_CYCLES 0
+#define BENCH_COUNTER "none"
+#endif
+
+#define BENCH_MAX_SIZE (64 * 1024)
+#define BENCH_MAX_SAMPLES 1001
+#define BENCH_DEFAULT_SAMPLES 51
+#define BENCH_BATCH_NS 20000.0
+
+/* Keep the compiler from discarding or hoisting the work being timed */
+#if defined(__GNUC__)
+#define BENCH_DO_NOT_OPTIMIZE(p) __asm__ volatile("" : : "r"(p) : "memory")
+#else
+static volatile const void *bench_sink;
+#define BENCH_DO_NOT_OPTIMIZE(p) (bench_sink = (p))
+#endif
+
+typedef struct {
+    SStr dest;
+    const char *src; /* size characters followed by a terminator */
+    SStrView view;   /* the same characters as a view */
+    size_t size;
+} BenchContext;
+
+typedef void (*BenchFn)(BenchContext *ctx);
+
+typedef struct {
+    const char *name;      /* Reported name, e.g. "sstr_copy" */
+    const char *operation; /* Operation shared with its baseline, e.g. "copy" */
+    const char *impl;      /* "sstr" or "std" */
+    BenchFn fn;
+} BenchCase;
+
+static char bench_src[BENCH_MAX_SIZE + 1];
+static char bench_dest[BENCH_MAX_SIZE + 64 + 1]; /* Room for a header before the source */
+
+static void bench_sstr_copy(BenchContext *ctx)
+{
+    sstr_copy(&ctx->dest, ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_copy(BenchContext *ctx)
+{
+    strcpy(ctx->dest.data, ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_copy_n(BenchContext *ctx)
+{
+    sstr_copy_n(&ctx->dest, ctx->src, ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_copy_n(BenchContext *ctx)
+{
+    memcpy(ctx->dest.data, ctx->src, ctx->size);
+    ctx->dest.data[ctx->size] = '\0';
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_copy_view(BenchContext *ctx)
+{
+    sstr_copy_view(&ctx->dest, ctx->view);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_append(BenchContext *ctx)
+{
+    sstr_clear(&ctx->dest);
+    sstr_append(&ctx->dest, ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_append(BenchContext *ctx)
+{
+    ctx->dest.data[0] = '\0';
+    strcat(ctx->dest.data, ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_format(BenchContext *ctx)
+{
+    sstr_format(&ctx->dest, "%s", ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_format(BenchContext *ctx)
+{
+    snprintf(ctx->dest.data, ctx->dest.capacity + 1, "%s", ctx->src);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_append_int(BenchContext *ctx)
+{
+    sstr_copy_view(&ctx->dest, SSTR_VIEW_LIT("Value: "));
+    sstr_append_i64(&ctx->dest, (int64_t)ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_sstr_format_int(BenchContext *ctx)
+{
+    sstr_format(&ctx->dest, "Value: %d", (int)ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_format_int(BenchContext *ctx)
+{
+    snprintf(ctx->dest.data, ctx->dest.capacity + 1, "Value: %d", (int)ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+/* The searches scan the whole source, which never holds the target */
+static void bench_sstr_find_char(BenchContext *ctx)
+{
+    size_t index = sstr_view_find_char(ctx->view, 'b');
+    BENCH_DO_NOT_OPTIMIZE(&index);
+}
+
+static void bench_std_find_char(BenchContext *ctx)
+{
+    const void *found = memchr(ctx->src, 'b', ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(found);
+}
+
+static void bench_sstr_find(BenchContext *ctx)
+{
+    size_t index = sstr_view_find(ctx->view, SSTR_VIEW_LIT("aab"));
+    BENCH_DO_NOT_OPTIMIZE(&index);
+}
+
+static void bench_std_find(BenchContext *ctx)
+{
+    const char *found = strstr(ctx->src, "aab");
+    BENCH_DO_NOT_OPTIMIZE(found);
+}
+
+static void bench_sstr_split(BenchContext *ctx)
+{
+    SStrSplitIter it;
+    SStrView token;
+    size_t tokens = 0;
+
+    sstr_split_init_set(&it, ctx->view, SSTR_VIEW_LIT(",;="));
+    while (sstr_split_next(&it, &token)) {
+        tokens++;
+    }
+    BENCH_DO_NOT_OPTIMIZE(&tokens);
+}
+
+static void bench_std_split(BenchContext *ctx)
+{
+    const char *p = ctx->src;
+    size_t tokens = 0;
+
+    for (;;) {
+        p += strcspn(p, ",;=");
+        tokens++;
+        if (*p == '\0') {
+            break;
+        }
+        p++;
+    }
+    BENCH_DO_NOT_OPTIMIZE(&tokens);
+}
+
+static void bench_sstr_hash(BenchContext *ctx)
+{
+    uint64_t hash = sstr_view_hash(ctx->view);
+    BENCH_DO_NOT_OPTIMIZE(&hash);
+}
+
+/* The parses read a fixed 19-digit field, whatever the size */
+static void bench_sstr_parse_u64(BenchContext *ctx)
+{
+    uint64_t value = 0;
+    (void)ctx;
+    sstr_parse_u64(SSTR_VIEW_LIT("1234567890123456789"), &value, NULL);
+    BENCH_DO_NOT_OPTIMIZE(&value);
+}
+
+static void bench_std_parse_u64(BenchContext *ctx)
+{
+    static const char *volatile field = "1234567890123456789";
+    unsigned long long value;
+    (void)ctx;
+    value = strtoull(field, NULL, 10);
+    BENCH_DO_NOT_OPTIMIZE(&value);
+}
+
+/* Both lower-case a copy of the source */
+static void bench_sstr_to_lower(BenchContext *ctx)
+{
+    sstr_copy_view(&ctx->dest, ctx->view);
+    sstr_to_lower(&ctx->dest);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_to_lower(BenchContext *ctx)
+{
+    for (size_t i = 0; i < ctx->size; i++) {
+        ctx->dest.data[i] = (char)tolower((unsigned char)ctx->src[i]);
+    }
+    ctx->dest.data[ctx->size] = '\0';
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+/* The stream cases write the source in 64-byte pieces through a 512-byte
+ * buffer, to a callback that discards it or to a FILE on /dev/null */
+#define BENCH_STREAM_PIECE 64
+#define BENCH_STREAM_BUFFER 512
+
+static SStrResult bench_discard(void *context, const char *data, size_t length)
+{
+    (void)context;
+    BENCH_DO_NOT_OPTIMIZE(data);
+    (void)length;
+    return SSTR_SUCCESS;
+}
+
+static void bench_sstr_stream(BenchContext *ctx)
+{
+    static char buffer[BENCH_STREAM_BUFFER];
+    SStrSink sink;
+
+    sstr_sink_init(&sink, buffer, sizeof(buffer), bench_discard, NULL);
+    for (size_t i = 0; i < ctx->size; i += BENCH_STREAM_PIECE) {
+        size_t n = ctx->size - i < BENCH_STREAM_PIECE ? ctx->size - i : BENCH_STREAM_PIECE;
+        sstr_sink_write(&sink, ctx->src + i, n);
+    }
+    sstr_sink_flush(&sink);
+}
+
+static void bench_std_stream(BenchContext *ctx)
+{
+    static FILE *null_file;
+
+    if (null_file == NULL) {
+        null_file = fopen("/dev/null", "w");
+        if (null_file == NULL) {
+            return;
+        }
+        setvbuf(null_file, NULL, _IOFBF, BENCH_STREAM_BUFFER);
+    }
+
+    for (size_t i = 0; i < ctx->size; i += BENCH_STREAM_PIECE) {
+        size_t n = ctx->size - i < BENCH_STREAM_PIECE ? ctx->size - i : BENCH_STREAM_PIECE;
+        fwrite(ctx->src + i, 1, n, null_file);
+    }
+    fflush(null_file);
+}
+
+/* The gather cases assemble a short header and the source as the body,
+ * as iovec entries over a chain or copied into one buffer */
+static void bench_sstr_gather(BenchContext *ctx)
+{
+    static SStrView segments[4];
+    static char scratch[64];
+    struct iovec iov[4];
+    SStrChain chain;
+
+    sstr_chain_init(&chain, segments, 4, scratch, sizeof(scratch));
+    sstr_chain_append_view(&chain, SSTR_VIEW_LIT("HTTP/1.1 200 OK\r\n\r\n"));
+    sstr_chain_append_view(&chain, ctx->view);
+    size_t n = sstr_chain_iov(&chain, iov, 4);
+    BENCH_DO_NOT_OPTIMIZE(iov);
+    BENCH_DO_NOT_OPTIMIZE(&n);
+}
+
+static void bench_std_gather(BenchContext *ctx)
+{
+    static const char header[] = "HTTP/1.1 200 OK\r\n\r\n";
+    memcpy(ctx->dest.data, header, sizeof(header) - 1);
+    memcpy(ctx->dest.data + sizeof(header) - 1, ctx->src, ctx->size);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+/* Both JSON-escape the source, which needs no escapes, so the SIMD run
+ * scan is compared with a byte-at-a-time escape loop */
+static void bench_sstr_json_escape(BenchContext *ctx)
+{
+    sstr_clear(&ctx->dest);
+    sstr_append_json_escaped(&ctx->dest, ctx->view);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_json_escape(BenchContext *ctx)
+{
+    char *out = ctx->dest.data;
+    for (size_t i = 0; i < ctx->size; i++) {
+        unsigned char c = (unsigned char)ctx->src[i];
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = (char)c;
+        } else if (c < 0x20) {
+            out += sprintf(out, "\\u%04x", c);
+        } else {
+            *out++ = (char)c;
+        }
+    }
+    *out = '\0';
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+/* Both hex-encode the first half of the source, so the output is size
+ * characters */
+static void bench_sstr_hex(BenchContext *ctx)
+{
+    sstr_clear(&ctx->dest);
+    sstr_append_hex_bytes(&ctx->dest, ctx->src, ctx->size / 2, 0);
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+static void bench_std_hex(BenchContext *ctx)
+{
+    for (size_t i = 0; i < ctx->size / 2; i++) {
+        snprintf(ctx->dest.data + 2 * i, 3, "%02x", (unsigned char)ctx->src[i]);
+    }
+    BENCH_DO_NOT_OPTIMIZE(ctx->dest.data);
+}
+
+/* All refresh a table of size / 16 + 1 entries in 16-byte slots, each from
+ * the first 15 characters of the source */
+#define BENCH_TABLE_SLOT 16
+#define BENCH_TABLE_MAX (BENCH_MAX_SIZE / BENCH_TABLE_SLOT + 1)
+
+static SStr bench_table[BENCH_TABLE_MAX];
+static SStrView bench_table_views[BENCH_TABLE_MAX];
+static char bench_table_block[BENCH_TABLE_MAX * BENCH_TABLE_SLOT];
+
+static size_t bench_table_entries(const BenchContext *ctx)
+{
+    static int ready;
+
+    if (!ready) {
+        sstr_array_init(bench_table, BENCH_TABLE_MAX, bench_table_block, BENCH_TABLE_SLOT);
+        for (size_t i = 0; i < BENCH_TABLE_MAX; i++) {
+            bench_table_views[i].data = bench_src;
+            bench_table_views[i].length = BENCH_TABLE_SLOT - 1;
+        }
+        ready = 1;
+    }
+
+    return ctx->size / BENCH_TABLE_SLOT + 1;
+}
+
+static void bench_sstr_table(BenchContext *ctx)
+{
+    sstr_array_copy_views(bench_table, bench_table_views, bench_table_entries(ctx));
+    BENCH_DO_NOT_OPTIMIZE(bench_table_block);
+}
+
+static void bench_sstr_table_loop(BenchContext *ctx)
+{
+    size_t entries = bench_table_entries(ctx);
+    for (size_t i = 0; i < entries; i++) {
+        sstr_clear(&bench_table[i]);
+        sstr_copy_view(&bench_table[i], bench_table_views[i]);
+    }
+    BENCH_DO_NOT_OPTIMIZE(bench_table_block);
+}
+
+static void bench_std_table(BenchContext *ctx)
+{
+    size_t entries = bench_table_entries(ctx);
+    for (size_t i = 0; i < entries; i++) {
+        char *slot = bench_table_block + i * BENCH_TABLE_SLOT;
+        memcpy(slot, bench_table_views[i].data, bench_table_views[i].length);
+        slot[bench_table_views[i].length] = '\0';
+    }
+    BENCH_DO_NOT_OPTIMIZE(bench_table_block);
+}
+
+static const BenchCase bench_cases[] = {
+    {"sstr_copy", "copy", "sstr", bench_sstr_copy},
+    {"strcpy", "copy", "std", bench_std_copy},
+    {"sstr_copy_n", "copy_n", "sstr", bench_sstr_copy_n},
+    {"memcpy", "copy_n", "std", bench_std_copy_n},
+    {"sstr_copy_view", "copy_view", "sstr", bench_sstr_copy_view},
+    {"sstr_append", "append", "sstr", bench_sstr_append},
+    {"strcat", "append", "std", bench_std_append},
+    {"sstr_format", "format", "sstr", bench_sstr_format},
+    {"snprintf", "format", "std", bench_std_format},
+    {"sstr_append_i64", "append_int", "sstr", bench_sstr_append_int},
+    {"sstr_format_int", "append_int", "sstr", bench_sstr_format_int},
+    {"snprintf_int", "append_int", "std", bench_std_format_int},
+    {"sstr_find_char", "find_char", "sstr", bench_sstr_find_char},
+    {"memchr", "find_char", "std", bench_std_find_char},
+    {"sstr_find", "find", "sstr", bench_sstr_find},
+    {"strstr", "find", "std", bench_std_find},
+    {"sstr_split", "split", "sstr", bench_sstr_split},
+    {"strcspn", "split", "std", bench_std_split},
+    {"sstr_view_hash", "hash", "sstr", bench_sstr_hash},
+    {"sstr_to_lower", "to_lower", "sstr", bench_sstr_to_lower},
+    {"tolower", "to_lower", "std", bench_std_to_lower},
+    {"sstr_parse_u64", "parse_u64", "sstr", bench_sstr_parse_u64},
+    {"strtoull", "parse_u64", "std", bench_std_parse_u64},
+    {"sstr_sink_write", "stream", "sstr", bench_sstr_stream},
+    {"fwrite", "stream", "std", bench_std_stream},
+    {"sstr_chain_iov", "gather", "sstr", bench_sstr_gather},
+    {"memcpy_gather", "gather", "std", bench_std_gather},
+    {"sstr_append_json_escaped", "json_escape", "sstr", bench_sstr_json_escape},
+    {"json_escape_loop", "json_escape", "std", bench_std_json_escape},
+    {"sstr_append_hex_bytes", "hex", "sstr", bench_sstr_hex},
+    {"snprintf_hex", "hex", "std", bench_std_hex},
+    {"sstr_array_copy_views", "table", "sstr", bench_sstr_table},
+    {"sstr_copy_view_loop", "table", "sstr", bench_sstr_table_loop},
+    {"memcpy_table", "table", "std", bench_std_table},
+};
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t bench_cycles(void)
+{
+#if BENCH_HAS_CYCLES
+    return (uint64_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted values */
+static double percentile(const double *sorted, size_t count, double p)
+{
+    size_t rank = (size_t)(p / 100.0 * (double)(count - 1) + 0.5);
+    return sorted[rank];
+}
+
+/* Time one case at one size and print its JSON result object */
+static void bench_run(FILE *out, const BenchCase *bench, size_t size, size_t samples, int first)
+{
+    static double ns_per_op[BENCH_MAX_SAMPLES];
+    static double cycles_per_op[BENCH_MAX_SAMPLES];
+    BenchContext ctx;
+
+    memset(bench_src, 'a', size);
+    bench_src[size] = '\0';
+    sstr_init(&ctx.dest, bench_dest, sizeof(bench_dest));
+    ctx.src = bench_src;
+    ctx.view.data = bench_src;
+    ctx.view.length = size;
+    ctx.size = size;
+
+    /* Warm up while doubling the batch until it runs for BENCH_BATCH_NS */
+    size_t batch = 1;
+    for (;;) {
+        double start = bench_now_ns();
+        for (size_t i = 0; i < batch; i++) {
+            bench->fn(&ctx);
+        }
+        if (bench_now_ns() - start >= BENCH_BATCH_NS || batch >= ((size_t)1 << 24)) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    double sum = 0.0;
+    for (size_t s = 0; s < samples; s++) {
+        uint64_t cycles_start = bench_cycles();
+        double start = bench_now_ns();
+        for (size_t i = 0; i < batch; i++) {
+            bench->fn(&ctx);
+        }
+        double elapsed = bench_now_ns() - start;
+        uint64_t cycles = bench_cycles() - cycles_start;
+
+        ns_per_op[s] = elapsed / (double)batch;
+        cycles_per_op[s] = (double)cycles / (double)batch;
+        sum += ns_per_op[s];
+    }
+
+    double mean = sum / (double)samples;
+    double variance = 0.0;
+    for (size_t s = 0; s < samples; s++) {
+        variance += (ns_per_op[s] - mean) * (ns_per_op[s] - mean);
+    }
+    double stddev = samples > 1 ? sqrt(variance / (double)(samples - 1)) : 0.0;
+
+    qsort(ns_per_op, samples, sizeof(ns_per_op[0]), compare_doubles);
+    qsort(cycles_per_op, samples, sizeof(cycles_per_op[0]), compare_doubles);
+    double median = percentile(ns_per_op, samples, 50.0);
+    double median_cycles = percentile(cycles_per_op, samples, 50.0);
+
+    fprintf(out, "%s\n    {\"command\": \"%s\", \"operation\": \"%s\", \"impl\": \"%s\", ",
+            first ? "" : ",", bench->name, bench->operation, bench->impl);
+    fprintf(out, "\"size\": %zu, \"iterations\": %zu, \"samples\": %zu,\n", size, batch, samples);
+    fprintf(out, "     \"ns_per_op\": %.3f, \"bytes_per_cycle\": ", median);
+    if (BENCH_HAS_CYCLES && median_cycles > 0.0) {
+        fprintf(out, "%.4f", (double)size / median_cycles);
+    } else {
+        fprintf(out, "null");
+    }
+    fprintf(out, ", \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f,\n", median,
+            percentile(ns_per_op, samples, 90.0), percentile(ns_per_op, samples, 99.0));
+    fprintf(out, "     \"mean\": %.6e, \"stddev\": %.6e, \"min\": %.6e, \"max\": %.6e}",
+            mean * 1e-9, stddev * 1e-9, ns_per_op[0] * 1e-9, ns_per_op[samples - 1] * 1e-9);
+}
+
+/* Whether any comma-separated part of filter occurs in the case's name or
+ * operation */
+static int bench_matches(const BenchCase *bench, const char *filter)
+{
+    while (*filter != '\0') {
+        char part[64];
+        size_t n = strcspn(filter, ",");
+        if (n > 0 && n < sizeof(part)) {
+            memcpy(part, filter, n);
+            part[n] = '\0';
+            if (strstr(bench->name, part) != NULL || strstr(bench->operation, part) != NULL) {
+                return 1;
+            }
+        }
+        filter += n;
+        if (*filter == ',') {
+            filter++;
+        }
+    }
+
+    return 0;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [--filter TEXT[,TEXT...]] [--max-size BYTES] [--samples N] "
+            "[--output FILE]\n",
+            program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = NULL;
+    const char *output = NULL;
+    size_t max_size = BENCH_MAX_SIZE;
+    size_t samples = BENCH_DEFAULT_SAMPLES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            max_size = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            samples = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (max_size < 1 || max_size > BENCH_MAX_SIZE || samples < 1 ||
+        samples > BENCH_MAX_SAMPLES) {
+        fprintf(stderr, "Sizes must be 1..%d bytes and samples 1..%d\n", BENCH_MAX_SIZE,
+                BENCH_MAX_SAMPLES);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"sstr_bench\",\n  \"counter\": \"%s\",\n",
+            BENCH_COUNTER);
+    fprintf(out, "  \"results\": [");
+
+    int first = 1;
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const BenchCase *bench = &bench_cases[c];
+        if (filter != NULL && !bench_matches(bench, filter)) {
+            continue;
+        }
+        for (size_t size = 1; size <= max_size; size *= 2) {
+            bench_run(out, bench, size, samples, first);
+            first = 0;
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return 0;
+}
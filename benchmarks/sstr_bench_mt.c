@@ -0,0 +1,232 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * Multi-threaded formatting throughput.
+ *
+ * Usage: sstr_bench_mt [--threads N] [--duration-ms MS] [--output FILE]
+ *
+ * Formats a log line concurrently from 1, 2, 4, ... up to N threads (the
+ * online CPU count by default), each into its own buffer, and reports the
+ * total and per-thread throughput as JSON. "scaling" is the per-thread
+ * throughput relative to one thread, so 1.0 means perfect scaling. The
+ * sstr_format_exec case shares one compiled program between all threads.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../include/sstr/sstr.h"
+
+#define BENCH_MT_MAX_THREADS 256
+#define BENCH_MT_DEFAULT_DURATION_MS 200
+
+/* Keep the compiler from discarding the work being timed */
+#if defined(__GNUC__)
+#define BENCH_DO_NOT_OPTIMIZE(p) __asm__ volatile("" : : "r"(p) : "memory")
+#else
+static volatile const void *bench_sink;
+#define BENCH_DO_NOT_OPTIMIZE(p) (bench_sink = (p))
+#endif
+
+#define BENCH_MT_FORMAT "%s id=%d latency=%uus status=%x path=%-12s|"
+
+typedef void (*BenchMtFn)(char *buffer, size_t size, int i);
+
+typedef struct {
+    const char *name;      /* Reported name, e.g. "sstr_format" */
+    const char *operation; /* Operation shared with its baseline */
+    const char *impl;      /* "sstr" or "std" */
+    BenchMtFn fn;
+} BenchMtCase;
+
+typedef struct {
+    const BenchMtCase *bench;
+    size_t iterations;
+    pthread_barrier_t *start;
+} BenchMtWorker;
+
+static SStrFormatProgram bench_program;
+
+static void bench_mt_sstr_format(char *buffer, size_t size, int i)
+{
+    SStr s;
+    sstr_init(&s, buffer, size);
+    sstr_format(&s, BENCH_MT_FORMAT, "GET", i, (unsigned)i * 7u, (unsigned)i, "/metrics");
+    BENCH_DO_NOT_OPTIMIZE(buffer);
+}
+
+static void bench_mt_sstr_format_exec(char *buffer, size_t size, int i)
+{
+    SStr s;
+    sstr_init(&s, buffer, size);
+    sstr_format_exec(&s, &bench_program, "GET", i, (unsigned)i * 7u, (unsigned)i, "/metrics");
+    BENCH_DO_NOT_OPTIMIZE(buffer);
+}
+
+static void bench_mt_snprintf(char *buffer, size_t size, int i)
+{
+    snprintf(buffer, size, BENCH_MT_FORMAT, "GET", i, (unsigned)i * 7u, (unsigned)i, "/metrics");
+    BENCH_DO_NOT_OPTIMIZE(buffer);
+}
+
+static const BenchMtCase bench_mt_cases[] = {
+    {"sstr_format", "format_mt", "sstr", bench_mt_sstr_format},
+    {"sstr_format_exec", "format_mt", "sstr", bench_mt_sstr_format_exec},
+    {"snprintf", "format_mt", "std", bench_mt_snprintf},
+};
+
+static double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void *bench_mt_worker(void *arg)
+{
+    BenchMtWorker *worker = (BenchMtWorker *)arg;
+    char buffer[128];
+
+    pthread_barrier_wait(worker->start);
+    for (size_t i = 0; i < worker->iterations; i++) {
+        worker->bench->fn(buffer, sizeof(buffer), (int)i);
+    }
+
+    return NULL;
+}
+
+/* Run iterations calls on each of threads threads, returning the wall time
+ * in nanoseconds from their common start to the last one finishing */
+static double bench_mt_time(const BenchMtCase *bench, size_t threads, size_t iterations)
+{
+    static pthread_t ids[BENCH_MT_MAX_THREADS];
+    static BenchMtWorker workers[BENCH_MT_MAX_THREADS];
+    pthread_barrier_t start;
+
+    pthread_barrier_init(&start, NULL, (unsigned)threads + 1);
+    for (size_t t = 0; t < threads; t++) {
+        workers[t].bench = bench;
+        workers[t].iterations = iterations;
+        workers[t].start = &start;
+        pthread_create(&ids[t], NULL, bench_mt_worker, &workers[t]);
+    }
+
+    pthread_barrier_wait(&start);
+    double begin = bench_now_ns();
+    for (size_t t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    double elapsed = bench_now_ns() - begin;
+
+    pthread_barrier_destroy(&start);
+    return elapsed;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--threads N] [--duration-ms MS] [--output FILE]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *output = NULL;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = cpus > 0 ? (size_t)cpus : 1;
+    double duration_ns = BENCH_MT_DEFAULT_DURATION_MS * 1e6;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            duration_ns = (double)strtoul(argv[++i], NULL, 10) * 1e6;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (max_threads < 1 || max_threads > BENCH_MT_MAX_THREADS || duration_ns <= 0.0) {
+        fprintf(stderr, "Threads must be 1..%d and the duration positive\n",
+                BENCH_MT_MAX_THREADS);
+        return 1;
+    }
+
+    if (sstr_format_compile(&bench_program, BENCH_MT_FORMAT) != SSTR_SUCCESS) {
+        fprintf(stderr, "Benchmark format does not compile\n");
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"sstr_bench_mt\",\n  \"cpus\": %ld,\n", cpus);
+    fprintf(out, "  \"results\": [");
+
+    int first = 1;
+    for (size_t c = 0; c < sizeof(bench_mt_cases) / sizeof(bench_mt_cases[0]); c++) {
+        const BenchMtCase *bench = &bench_mt_cases[c];
+
+        /* Size the run so one thread takes about the requested duration */
+        size_t iterations = 1000;
+        double elapsed = bench_mt_time(bench, 1, iterations);
+        while (elapsed < duration_ns / 8.0 && iterations < ((size_t)1 << 30)) {
+            iterations *= 2;
+            elapsed = bench_mt_time(bench, 1, iterations);
+        }
+        iterations = (size_t)((double)iterations * duration_ns / elapsed) + 1;
+
+        double single = 0.0;
+        /* Powers of two, always ending with max_threads itself */
+        for (size_t threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads) {
+            elapsed = bench_mt_time(bench, threads, iterations);
+            double ops = (double)(threads * iterations);
+            double per_second = ops / (elapsed * 1e-9);
+            double per_thread = per_second / (double)threads;
+            if (threads == 1) {
+                single = per_thread;
+            }
+
+            fprintf(out, "%s\n    {\"command\": \"%s\", \"operation\": \"%s\", \"impl\": \"%s\", ",
+                    first ? "" : ",", bench->name, bench->operation, bench->impl);
+            fprintf(out, "\"threads\": %zu, \"ops\": %.0f, \"seconds\": %.6f,\n", threads, ops,
+                    elapsed * 1e-9);
+            fprintf(out, "     \"ops_per_sec\": %.0f, \"ops_per_sec_per_thread\": %.0f, ",
+                    per_second, per_thread);
+            fprintf(out, "\"scaling\": %.3f}", per_thread / single);
+            first = 0;
+
+            if (threads == max_threads) {
+                break;
+            }
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    return 0;
+}
@@ -8,7 +8,8 @@ set -e
 OUTPUT_FILE="single_include/sstr.h"
 CONFIG_FILE="include/sstr/sstr_config.h"
 HEADER_FILE="include/sstr/sstr.h"
-IMPLEMENTATION_FILES=("src/sstr.c" "src/sstr_format.c")
+IMPLEMENTATION_FILES=("src/sstr.c" "src/sstr_format.c" "src/sstr_arena.c" "src/sstr_intern.c"
+                      "src/sstr_parse.c" "src/sstr_sink.c" "src/sstr_chain.c")
 
 # Create output directory if it doesn't exist
 mkdir -p "$(dirname "$OUTPUT_FILE")"
@@ -39,11 +40,19 @@ cat > "$OUTPUT_FILE" << 'EOF'
  * A minimal, bounds-checked string handling library designed for embedded systems
  * with no dynamic memory allocation.
  *
+ * All functions are reentrant: there is no global mutable state (except the
+ * optional atomic statistics counters), no locking and no locale dependence
+ * outside the optional vsnprintf fallback. Objects are not synchronized, so one
+ * object must not be written by a thread while others use it.
+ *
  * Usage:
  *   1. Include this file in any C file that needs to use SStr
  *   2. In EXACTLY ONE C file, define SSTR_IMPLEMENTATION before including:
  *      #define SSTR_IMPLEMENTATION
  *      #include "sstr.h"
+ *   3. Define any configuration macros (see sstr_config.h), such as
+ *      SSTR_ENABLE_FORMAT 0 or SSTR_INLINE_FAST_PATHS 1, the same way before
+ *      every include
  */
 
 #ifndef SSTR_H
@@ -66,10 +75,11 @@ tail -n +20 "$CONFIG_FILE" | sed -e :a -e '$d;N;2,1ba' -e 'P;D' >> "$OUTPUT_FILE
 
 # Add the header content (function declarations)
 echo "Adding API declarations from $HEADER_FILE"
-# Skip first 20 lines (copyright, comments, include guards)
+# Skip everything up to the include guard (copyright, comments)
 # Also skip the includes for sstr_config.h
 # Using a more portable approach than 'head -n -1' which doesn't work on macOS GitHub Actions
-awk 'NR>20 && !/sstr_config\.h/' "$HEADER_FILE" | sed -e :a -e '$d;N;2,1ba' -e 'P;D' >> "$OUTPUT_FILE"
+awk 'body && !/sstr_config\.h/; /^#define SSTR_H$/ { body = 1 }' "$HEADER_FILE" |
+    sed -e :a -e '$d;N;2,1ba' -e 'P;D' >> "$OUTPUT_FILE"
 
 # Add the C++ closing bracket and transition to implementation
 cat >> "$OUTPUT_FILE" << 'EOF'
@@ -88,6 +98,7 @@ cat >> "$OUTPUT_FILE" << 'EOF'
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <limits.h>
 #include <stdint.h> /* For SIZE_MAX */
 
 /* CBMC stubs for verification - empty macros when not using CBMC */
@@ -109,9 +120,11 @@ for impl_file in "${IMPLEMENTATION_FILES[@]}"; do
   # Skip includes, copyright, and empty lines at the start
   awk '
     BEGIN { in_function = 0; print_line = 0; }
+    /^#include </ { if (print_line) { print; next; } }  # Keep target-specific system includes
     /^#include/ { next; }  # Skip includes
     /^\/\*/ { if (!print_line) next; }  # Skip copyright comment blocks at start
     /^$/ { if (!print_line) next; }  # Skip empty lines at start
+    /^#(if|define)/ { print_line = 1; }  # Configuration-dependent code and macros
     /^[a-zA-Z_][a-zA-Z0-9_]* .*\(.*\)/ { in_function = 1; print_line = 1; }  # Start of function
     in_function && /^}/ { print; in_function = 0; print ""; next; }  # End of function
     /^static/ { print_line = 1; }  # Static functions/variables
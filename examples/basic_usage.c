@@ -39,7 +39,8 @@ int main(void)
         printf("Failed to copy string with length\n");
         return 1;
     }
-    printf("Partial copy: %s (length: %zu, capacity: %zu)\n", str.data, str.length, str.capacity);
+    printf("Partial copy: %s (length: %zu, capacity: %zu)\n", str.data, (size_t)str.length,
+           (size_t)str.capacity);
 
     /* Append another string */
     result = sstr_append(&str, "world!");
@@ -49,7 +50,8 @@ int main(void)
     }
 
     /* Print the result */
-    printf("Result: %s (length: %zu, capacity: %zu)\n", str.data, str.length, str.capacity);
+    printf("Result: %s (length: %zu, capacity: %zu)\n", str.data, (size_t)str.length,
+           (size_t)str.capacity);
 
     /* Format a string */
     int chars_written = sstr_format(&str, "The answer is %d", 42);
@@ -58,7 +60,8 @@ int main(void)
         return 1;
     }
 
-    printf("Formatted: %s (length: %zu, capacity: %zu)\n", str.data, str.length, str.capacity);
+    printf("Formatted: %s (length: %zu, capacity: %zu)\n", str.data, (size_t)str.length,
+           (size_t)str.capacity);
 
     /* Test overflow handling (default is SSTR_ERROR policy) */
     char small_buffer[5];
@@ -68,7 +71,7 @@ int main(void)
     result = sstr_copy(&small_str, "This string is too long for the buffer");
     printf("Copy result with overflow: %d\n", result);
     printf("Small buffer content: %s (length: %zu, capacity: %zu)\n", small_str.data,
-           small_str.length, small_str.capacity);
+           (size_t)small_str.length, (size_t)small_str.capacity);
 
     return 0;
 }
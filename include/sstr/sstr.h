@@ -13,13 +13,23 @@
  *
  * A minimal, bounds-checked string handling library designed for embedded systems
  * with no dynamic memory allocation.
+ *
+ * All functions are reentrant: there is no global mutable state (except the
+ * optional atomic statistics counters), no locking and no locale dependence
+ * outside the optional vsnprintf fallback. Objects are not synchronized, so one
+ * object must not be written by a thread while others use it.
  */
 
 #ifndef SSTR_H
 #define SSTR_H
 
+#include "sstr_config.h"
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
+#if SSTR_ENABLE_IOVEC
+#include <sys/uio.h>
+#endif
 
 /**
  * Result codes for SStr operations
@@ -40,22 +50,235 @@ typedef enum {
     SSTR_ERROR     /* Return error when buffer is too small */
 } SStrTruncationPolicy;
 
+/**
+ * Type of the SStr length and capacity fields, selected by SSTR_LENGTH_BITS
+ */
+#if SSTR_LENGTH_BITS == 16
+typedef uint16_t sstr_len_t;
+#define SSTR_LENGTH_MAX ((size_t)UINT16_MAX)
+#elif SSTR_LENGTH_BITS == 32
+typedef uint32_t sstr_len_t;
+#define SSTR_LENGTH_MAX ((size_t)UINT32_MAX)
+#elif SSTR_LENGTH_BITS == 0
+typedef size_t sstr_len_t;
+#define SSTR_LENGTH_MAX ((size_t)SIZE_MAX)
+#else
+#error "SSTR_LENGTH_BITS must be 0, 16 or 32"
+#endif
+
+/**
+ * Largest capacity of a string whose buffer the library sizes itself
+ * (arena and growable strings): SSTR_MAX_SIZE, or less if the length type
+ * is narrower. One below the type maximum keeps capacity + 1 in range.
+ */
+#define SSTR_CAPACITY_MAX                                                                          \
+    (SSTR_MAX_SIZE < SSTR_LENGTH_MAX - 1 ? SSTR_MAX_SIZE : SSTR_LENGTH_MAX - 1)
+
+#if SSTR_ENABLE_GROWABLE
+/**
+ * Allocator hook for growable strings
+ *
+ * resize behaves like realloc with the old size passed in: ptr is NULL
+ * with old_size 0 for a new buffer, and a new_size of 0 frees ptr. It
+ * returns NULL on failure, leaving ptr untouched.
+ */
+typedef struct {
+    void *(*resize)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void *ctx; /* Passed to every resize call */
+} SStrAllocator;
+#endif
+
 /**
  * SStr structure - contains a pointer to a stack-allocated buffer
  * along with capacity and current length information
  */
 typedef struct {
-    char *data;      /* Points to stack-allocated buffer */
-    size_t capacity; /* Maximum usable characters (excluding null terminator) */
-    size_t length;   /* Current string length */
+    char *data;          /* Points to stack-allocated buffer */
+    sstr_len_t capacity; /* Maximum usable characters (excluding null terminator) */
+    sstr_len_t length;   /* Current string length */
+#if SSTR_ENABLE_GROWABLE
+    const SStrAllocator *allocator; /* Owner of data, or NULL for a fixed buffer */
+#endif
 } SStr;
 
+/**
+ * Declare a string type with its buffer stored inline after the header
+ *
+ *     SSTR_DECLARE_INLINE(SStrKey, 23);
+ *     SStrKey key;
+ *     SSTR_INLINE_INIT(&key);
+ *     sstr_copy(&key.str, "device-42");
+ *
+ * The header and up to N characters sit in one object, so arrays of small
+ * strings are contiguous. Every sstr_* function works on &var.str. The
+ * header points at the object's own buffer: after copying or moving the
+ * object (assignment, memcpy, qsort), call SSTR_INLINE_REBIND on the copy.
+ */
+#define SSTR_DECLARE_INLINE(name, N)                                                               \
+    typedef struct {                                                                               \
+        SStr str;                                                                                  \
+        char buf[(N) + 1];                                                                         \
+    } name
+
+/**
+ * Initialize an inline string declared with SSTR_DECLARE_INLINE to empty
+ */
+#define SSTR_INLINE_INIT(s) sstr_init(&(s)->str, (s)->buf, sizeof((s)->buf))
+
+/**
+ * Point a copied or moved inline string back at its own buffer, keeping
+ * the content
+ */
+#define SSTR_INLINE_REBIND(s) ((void)((s)->str.data = (s)->buf))
+
+/**
+ * SStrView structure - a read-only, non-owning reference to characters
+ * with a known length. The data need not be null-terminated.
+ */
+typedef struct {
+    const char *data; /* First character, not owned */
+    size_t length;    /* Number of characters */
+} SStrView;
+
+/**
+ * View of a string literal, with the length computed at compile time
+ */
+#define SSTR_VIEW_LIT(lit) ((SStrView){"" lit "", sizeof(lit) - 1})
+
+/**
+ * Delimiters a split iterator matches a block at a time; larger sets are
+ * matched through the bitmap alone
+ */
+#define SSTR_SPLIT_SET_MAX 8
+
+/**
+ * SStrSplitIter structure - re-entrant tokenizer yielding views of the
+ * source between delimiters. Initialize with sstr_split_init or
+ * sstr_split_init_set; the fields are private to the iterator.
+ */
+typedef struct {
+    const char *data;                      /* Source characters, not owned */
+    size_t length;                         /* Number of source characters */
+    size_t pos;                            /* Start of the next token */
+    int done;                              /* Set once the last token is returned */
+    size_t count;                          /* Distinct delimiters */
+    unsigned char set[SSTR_SPLIT_SET_MAX]; /* The first distinct delimiters */
+    unsigned char map[32];                 /* Bit c set when byte c is a delimiter */
+} SStrSplitIter;
+
+/**
+ * SStrArena structure - bump allocator handing out SStr buffers from one
+ * caller-provided block. Strings are released together by a reset.
+ */
+typedef struct {
+    char *base;  /* Start of the caller-provided block */
+    size_t size; /* Size of the block in bytes */
+    size_t used; /* Bytes handed out so far */
+} SStrArena;
+
+/**
+ * Length of a free slot in an interning table's index
+ */
+#define SSTR_INTERN_EMPTY UINT32_MAX
+
+/**
+ * One slot of an interning table's index. Callers provide the array;
+ * sstr_intern_init fills it.
+ */
+typedef struct {
+    uint32_t hash;   /* Low 32 bits of the string's hash */
+    uint32_t offset; /* Start of the string in the pool */
+    uint32_t length; /* Length of the string, or SSTR_INTERN_EMPTY */
+} SStrInternSlot;
+
+/**
+ * SStrInternTable structure - keeps one copy of each distinct string in a
+ * caller-provided pool, indexed by an open-addressing hash table over a
+ * caller-provided slot array. No heap is used.
+ */
+typedef struct {
+    SStrInternSlot *slots; /* Index, a power of two in size */
+    size_t slot_mask;      /* Number of slots minus one */
+    size_t count;          /* Distinct strings interned */
+    size_t limit;          /* Most strings the index takes, below its size */
+    char *pool;            /* Characters of the strings, each terminated */
+    size_t pool_size;      /* Size of the pool in bytes */
+    size_t pool_used;      /* Pool bytes in use */
+    uint64_t seed;         /* Seed for sstr_view_hash_seed */
+} SStrInternTable;
+
+/**
+ * Callback receiving a sink's output. data holds length bytes, not
+ * terminated, valid only for the duration of the call. A result other than
+ * SSTR_SUCCESS is returned by the sink operation that flushed.
+ */
+typedef SStrResult (*SStrSinkFlush)(void *context, const char *data, size_t length);
+
+/**
+ * SStrSink structure - streams output of any size through a fixed
+ * caller-provided buffer, handing it to a flush callback in batches
+ * instead of overflowing. Initialize with sstr_sink_init.
+ */
+typedef struct {
+    SStr buffer;         /* Bytes not yet flushed */
+    SStrSinkFlush flush; /* Receives each batch */
+    void *context;       /* Passed through to flush */
+    size_t flushed;      /* Bytes handed to flush so far */
+} SStrSink;
+
+/**
+ * SStrChain structure - builds output as a list of segments for
+ * scatter-gather writes. Long pieces are referenced in place; short ones
+ * are copied into a caller-provided scratch buffer. Initialize with
+ * sstr_chain_init.
+ */
+typedef struct {
+    SStrView *segments; /* Caller-provided segment array */
+    size_t capacity;    /* Segments the array holds */
+    size_t first;       /* First segment not yet consumed */
+    size_t count;       /* Segments in use, including consumed ones */
+    size_t length;      /* Bytes in the unconsumed segments */
+    SStr scratch;       /* Copied pieces, referenced by segments */
+} SStrChain;
+
+/**
+ * A parsed printf conversion specification
+ */
+typedef struct {
+    unsigned char flags;  /* Conversion flags ('-', '+', ' ', '#', '0') */
+    unsigned char length; /* Length modifier (hh, h, l, ll, z, j, t) */
+    char conversion;      /* Conversion character, '\0' for none */
+    int width;            /* Minimum field width, 0 when absent */
+    int precision;        /* Precision, -1 when absent */
+} SStrFormatSpec;
+
+/**
+ * One step of a compiled format: a literal run followed by a conversion
+ */
+typedef struct {
+    const char *literal;   /* Literal text emitted before the conversion */
+    size_t literal_length; /* Length of the literal text */
+    SStrFormatSpec spec;   /* Conversion emitted after the literal */
+} SStrFormatOp;
+
+/**
+ * A format string validated and parsed once by sstr_format_compile
+ *
+ * Literal runs point into the original format string, which must outlive
+ * the program. The structure is fixed-size and needs no heap.
+ */
+typedef struct {
+    size_t op_count;
+    SStrFormatOp ops[SSTR_FORMAT_MAX_OPS];
+} SStrFormatProgram;
+
 /**
  * Initialize an SStr structure with a stack-allocated buffer
  *
  * @param s Pointer to SStr structure to initialize
  * @param buffer Pointer to stack-allocated character buffer
- * @param buffer_size Size of the buffer in bytes
+ * @param buffer_size Size of the buffer in bytes; with a narrow SSTR_LENGTH_BITS
+ *        only the first SSTR_LENGTH_MAX bytes are used
  * @return SSTR_SUCCESS or error code
  */
 SStrResult sstr_init(SStr *s, char *buffer, size_t buffer_size);
@@ -68,6 +291,52 @@ SStrResult sstr_init(SStr *s, char *buffer, size_t buffer_size);
  */
 SStrResult sstr_clear(SStr *s);
 
+/**
+ * Make sure an SStr can hold at least capacity characters
+ *
+ * A fixed buffer can only confirm that it is already large enough. A
+ * growable string is reallocated, to at least double its capacity, keeping
+ * its content.
+ *
+ * @param s SStr to reserve space in
+ * @param capacity Number of characters needed, excluding the terminator
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if the space is not available
+ */
+SStrResult sstr_reserve(SStr *s, size_t capacity);
+
+#if SSTR_ENABLE_GROWABLE
+/**
+ * Allocator using the C library's realloc and free
+ */
+extern const SStrAllocator sstr_heap_allocator;
+
+/**
+ * Initialize an empty SStr owning a buffer from an allocator
+ *
+ * The sstr_append family (views, batches, encoders and integers included),
+ * sstr_concat, sstr_format and sstr_append_format grow the buffer
+ * geometrically instead of overflowing, up to SSTR_CAPACITY_MAX. The
+ * truncation policy only applies when the allocator fails.
+ *
+ * @param s SStr to initialize
+ * @param allocator Allocator for the buffer, which must outlive s
+ * @param capacity Initial capacity, excluding the terminator
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if allocation fails
+ */
+SStrResult sstr_init_growable(SStr *s, const SStrAllocator *allocator, size_t capacity);
+
+/**
+ * Release the buffer of a growable SStr
+ *
+ * Afterwards s has no buffer and every operation on it fails with
+ * SSTR_ERROR_NULL. Strings with a fixed buffer are left unchanged.
+ *
+ * @param s SStr to release
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_free(SStr *s);
+#endif
+
 /**
  * Copy a C string into an SStr
  *
@@ -106,23 +375,1218 @@ SStrResult sstr_append(SStr *dest, const char *src);
 SStrResult sstr_append_sstr(SStr *dest, const SStr *src);
 
 /**
- * Format a string into an SStr (printf-style)
+ * Convert an SStr to lower case in place
+ *
+ * Only ASCII 'A' to 'Z' change, whatever the locale; other bytes,
+ * including NUL and UTF-8 sequences, are kept. All s->length characters
+ * are converted, a block at a time when SSTR_ENABLE_SIMD is set.
+ *
+ * @param s String to convert
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_to_lower(SStr *s);
+
+/**
+ * Convert an SStr to upper case in place, changing only ASCII 'a' to 'z'
+ *
+ * @param s String to convert
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_to_upper(SStr *s);
+
+/**
+ * Remove leading and trailing ASCII whitespace in place
+ *
+ * Whitespace is ' ', '\t', '\n', '\v', '\f' and '\r', as isspace in the C
+ * locale. s->length is updated and the result stays null-terminated.
+ *
+ * @param s String to trim
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_trim(SStr *s);
+
+/**
+ * Remove leading ASCII whitespace in place, moving the rest to the front
+ *
+ * @param s String to trim
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_trim_left(SStr *s);
+
+/**
+ * Remove trailing ASCII whitespace in place
+ *
+ * @param s String to trim
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_trim_right(SStr *s);
+
+/**
+ * Append src escaped for use inside a JSON string literal
+ *
+ * '"', '\\' and the control characters below 0x20 are escaped, using the
+ * short forms \b \t \n \f \r where they exist and \u00XX otherwise. Other
+ * bytes, including UTF-8 sequences, are copied unchanged and the surrounding
+ * quotes are not added. Runs that need no escaping are found a block at a
+ * time with SIMD where available. On truncation only whole escapes are kept.
+ *
+ * @param dest Destination string
+ * @param src Bytes to escape
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_append_json_escaped(SStr *dest, SStrView src);
+
+/**
+ * Append length bytes as two hex digits each
+ *
+ * @param dest Destination string
+ * @param data Bytes to encode
+ * @param length Number of bytes
+ * @param uppercase Use A-F instead of a-f if non-zero
+ * @return SSTR_SUCCESS or error code; on truncation only whole digit pairs
+ *         are kept
+ */
+SStrResult sstr_append_hex_bytes(SStr *dest, const void *data, size_t length, int uppercase);
+
+/**
+ * Append length bytes encoded as base64 (RFC 4648, with '=' padding)
+ *
+ * The output is exactly 4 * ceil(length / 3) characters.
+ *
+ * @param dest Destination string
+ * @param data Bytes to encode
+ * @param length Number of bytes
+ * @return SSTR_SUCCESS or error code; on truncation only whole groups of
+ *         four characters are kept
+ */
+SStrResult sstr_append_base64(SStr *dest, const void *data, size_t length);
+
+/**
+ * Create a view of a C string
+ *
+ * The terminator is searched for within SSTR_MAX_SIZE characters. A NULL
+ * or unterminated string gives a view with NULL data and zero length.
+ *
+ * @param src Source C string
+ * @return View of the string, excluding the terminator
+ */
+SStrView sstr_view_from_cstr(const char *src);
+
+/**
+ * Create a view of the current content of an SStr
+ *
+ * The view is invalidated by any later modification of the SStr.
+ *
+ * @param src Source SStr
+ * @return View of the content; NULL data and zero length if src is NULL
+ */
+SStrView sstr_view_from_sstr(const SStr *src);
+
+/**
+ * Copy a view into an SStr without scanning for a terminator
+ *
+ * The view may refer to the destination's own buffer.
  *
  * @param dest Destination SStr
- * @param fmt Format string
- * @param ... Format arguments
- * @return Number of characters written or negative error code
+ * @param src Source view
+ * @return SSTR_SUCCESS or error code
  */
-int sstr_format(SStr *dest, const char *fmt, ...);
+SStrResult sstr_copy_view(SStr *dest, SStrView src);
 
 /**
- * Format a string into an SStr with va_list
+ * Append a view to an SStr without scanning for a terminator
  *
  * @param dest Destination SStr
- * @param fmt Format string
- * @param args Variable argument list
- * @return Number of characters written or negative error code
+ * @param src Source view to append
+ * @return SSTR_SUCCESS or error code
  */
-int sstr_vformat(SStr *dest, const char *fmt, va_list args);
+SStrResult sstr_append_view(SStr *dest, SStrView src);
+
+/**
+ * Append several views with a single capacity check
+ *
+ * Under SSTR_ERROR either every part is appended or, if the total does not
+ * fit, dest is left unchanged. Under SSTR_TRUNCATE parts are appended until
+ * the destination is full.
+ *
+ * @param dest Destination SStr
+ * @param parts Array of views to append in order
+ * @param count Number of views in parts
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_append_many(SStr *dest, const SStrView *parts, size_t count);
+
+/**
+ * Append several C strings, terminated by a NULL argument
+ *
+ *     sstr_concat(&s, "GET ", path, " HTTP/1.1\r\n", (const char *)NULL);
+ *
+ * Each part is scanned and copied in one pass. Under SSTR_ERROR either every
+ * part is appended or dest is left unchanged. Prefer SSTR_CONCAT, which adds
+ * the terminating NULL.
+ *
+ * @param dest Destination SStr
+ * @param ... C strings to append, followed by (const char *)NULL
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_concat(SStr *dest, ...);
+
+/**
+ * Append several C strings with sstr_concat, adding the terminating NULL
+ */
+#define SSTR_CONCAT(dest, ...) sstr_concat(dest, __VA_ARGS__, (const char *)NULL)
+
+/**
+ * Initialize a table of strings over one block of equal slots
+ *
+ * Entry i uses the slot_size bytes at block + i * slot_size, as if set up
+ * with sstr_init. The arguments are checked once for the whole table.
+ *
+ * @param arr Array of n SStr structures
+ * @param n Number of entries
+ * @param block Buffer of at least n * slot_size bytes
+ * @param slot_size Bytes per entry, including the terminator
+ * @return SSTR_SUCCESS, SSTR_ERROR_NULL, or SSTR_ERROR_OVERFLOW for a zero
+ *         slot size or a table larger than SIZE_MAX bytes
+ */
+SStrResult sstr_array_init(SStr *arr, size_t n, char *block, size_t slot_size);
+
+/**
+ * Reset every string of a table to empty
+ *
+ * @param arr Array of n initialized SStr structures
+ * @param n Number of entries
+ * @return SSTR_SUCCESS, or SSTR_ERROR_NULL with no entry changed if an
+ *         entry has no buffer
+ */
+SStrResult sstr_array_clear(SStr *arr, size_t n);
+
+/**
+ * Copy views[i] into arr[i] for every entry of a table
+ *
+ * Every view is checked against its entry before anything is copied. Under
+ * SSTR_ERROR either every view is copied or, if one does not fit its entry,
+ * the table is left unchanged; under SSTR_TRUNCATE each view is truncated to
+ * its entry. A view may refer to its own entry, but not to another entry of
+ * the table. Entries do not grow.
+ *
+ * @param arr Array of n initialized SStr structures
+ * @param views Array of n source views
+ * @param n Number of entries
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_array_copy_views(SStr *arr, const SStrView *views, size_t n);
+
+/**
+ * Append the decimal digits of a signed integer, with a leading '-' if
+ * negative
+ *
+ * Digits are written straight into the free space without going through
+ * the format engine. Overflow follows the truncation policy as for
+ * sstr_append; under SSTR_TRUNCATE the leading digits are kept.
+ *
+ * @param dest Destination SStr
+ * @param value Value to append
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_append_i64(SStr *dest, int64_t value);
+
+/**
+ * Append the decimal digits of an unsigned integer
+ *
+ * @param dest Destination SStr
+ * @param value Value to append
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_append_u64(SStr *dest, uint64_t value);
+
+/**
+ * Append the hex digits of an unsigned integer, without a "0x" prefix
+ *
+ * @param dest Destination SStr
+ * @param value Value to append
+ * @param min_width Minimum number of digits, padded with leading zeros
+ * @param uppercase Nonzero for "A" to "F" instead of "a" to "f"
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_append_hex(SStr *dest, uint64_t value, size_t min_width, int uppercase);
+
+/**
+ * Parse a decimal integer from the start of a view
+ *
+ * Accepts an optional '+' or '-' followed by decimal digits, without
+ * skipping whitespace and independent of the locale. Digits are converted
+ * eight at a time. The view need not be terminated.
+ *
+ * With consumed non-NULL, parsing stops at the first non-digit and
+ * *consumed is set to the bytes used: the number on success, the whole
+ * digit run on overflow, 0 when there is no number. With consumed NULL the
+ * whole view must be the number.
+ *
+ * @param src Characters to parse
+ * @param out Set to the value on success, unchanged on error
+ * @param consumed Set to the number of bytes used, or NULL
+ * @return SSTR_SUCCESS, SSTR_ERROR_FORMAT if src does not start with (or,
+ *         with consumed NULL, is not) a number, SSTR_ERROR_OVERFLOW if the
+ *         value is out of range, or SSTR_ERROR_NULL
+ */
+SStrResult sstr_parse_i64(SStrView src, int64_t *out, size_t *consumed);
+
+/**
+ * Parse an unsigned decimal integer from the start of a view
+ *
+ * As sstr_parse_i64, but accepting only an optional '+' sign.
+ */
+SStrResult sstr_parse_u64(SStrView src, uint64_t *out, size_t *consumed);
+
+/**
+ * Parse a hexadecimal integer from the start of a view
+ *
+ * Accepts an optional "0x" or "0X" prefix followed by digits 0-9, a-f and
+ * A-F, with the same consumed and error rules as sstr_parse_i64. A "0x"
+ * with no hex digits after it parses as the number 0, consuming the "0".
+ */
+SStrResult sstr_parse_hex(SStrView src, uint64_t *out, size_t *consumed);
+
+/**
+ * Compare two views lexicographically by unsigned character value
+ *
+ * @param a First view
+ * @param b Second view
+ * @return Negative, zero or positive as a sorts before, equal to or after b
+ */
+int sstr_view_compare(SStrView a, SStrView b);
+
+/**
+ * Check two views for equal content
+ *
+ * @param a First view
+ * @param b Second view
+ * @return 1 if the views hold the same characters, 0 otherwise
+ */
+int sstr_view_equals(SStrView a, SStrView b);
+
+/**
+ * Compare two views lexicographically, folding ASCII 'A' to 'Z' to lower
+ * case; other bytes compare by unsigned value, independent of the locale
+ *
+ * @param a First view
+ * @param b Second view
+ * @return Negative, zero or positive as a sorts before, equal to or after b
+ */
+int sstr_view_compare_icase(SStrView a, SStrView b);
+
+/**
+ * Check two views for equal content, ignoring ASCII case
+ *
+ * @param a First view
+ * @param b Second view
+ * @return 1 if the views match ignoring ASCII case, 0 otherwise
+ */
+int sstr_view_equals_icase(SStrView a, SStrView b);
+
+/**
+ * Comparisons of SStr content, using the stored lengths
+ *
+ * Strings of different lengths are unequal without reading their content,
+ * and content after an embedded NUL takes part in the comparison. A NULL
+ * string compares as empty.
+ */
+int sstr_compare(const SStr *a, const SStr *b);
+int sstr_equals(const SStr *a, const SStr *b);
+int sstr_compare_icase(const SStr *a, const SStr *b);
+int sstr_equals_icase(const SStr *a, const SStr *b);
+
+/**
+ * Hash a view with a seed
+ *
+ * A fast non-cryptographic 64-bit hash in the style of wyhash, reading
+ * exactly v.length bytes. Equal content gives equal hashes for a given
+ * seed on every platform. A secret, per-table seed makes collisions hard
+ * to provoke from untrusted keys.
+ *
+ * @param v Characters to hash
+ * @param seed Seed mixed into the hash
+ * @return 64-bit hash value
+ */
+uint64_t sstr_view_hash_seed(SStrView v, uint64_t seed);
+
+/**
+ * Hash a view or SStr content with seed 0; a NULL string hashes as empty
+ */
+uint64_t sstr_view_hash(SStrView v);
+uint64_t sstr_hash(const SStr *s);
+
+/**
+ * Index returned by the search functions when there is no match
+ */
+#define SSTR_NPOS ((size_t)-1)
+
+/**
+ * Find the first occurrence of a character in an SStr
+ *
+ * The search covers s->length characters, so it neither stops at nor
+ * depends on the terminator. Blocks of characters are compared at once
+ * when SSTR_ENABLE_SIMD is set.
+ *
+ * @param s String to search
+ * @param c Character to find
+ * @return Index of the character, or SSTR_NPOS if absent or s is NULL
+ */
+size_t sstr_find_char(const SStr *s, char c);
+
+/**
+ * Find the last occurrence of a character in an SStr
+ *
+ * @param s String to search
+ * @param c Character to find
+ * @return Index of the character, or SSTR_NPOS if absent or s is NULL
+ */
+size_t sstr_rfind_char(const SStr *s, char c);
+
+/**
+ * Find the first occurrence of a substring in an SStr
+ *
+ * Candidate positions are filtered on the first and last character of the
+ * needle, a block of positions at a time, before the rest is compared.
+ * An empty needle matches at 0.
+ *
+ * @param s String to search
+ * @param needle Substring to find
+ * @return Index of the match, or SSTR_NPOS if absent or s is NULL
+ */
+size_t sstr_find(const SStr *s, SStrView needle);
+
+/**
+ * Find the last occurrence of a substring in an SStr
+ *
+ * An empty needle matches at s->length.
+ *
+ * @param s String to search
+ * @param needle Substring to find
+ * @return Index of the match, or SSTR_NPOS if absent or s is NULL
+ */
+size_t sstr_rfind(const SStr *s, SStrView needle);
+
+/**
+ * Searches over views, with the same results as the SStr versions
+ */
+size_t sstr_view_find_char(SStrView v, char c);
+size_t sstr_view_rfind_char(SStrView v, char c);
+size_t sstr_view_find(SStrView haystack, SStrView needle);
+size_t sstr_view_rfind(SStrView haystack, SStrView needle);
+
+/**
+ * Start splitting a view on a single delimiter character
+ *
+ * Neither the source nor the delimiter is modified or copied; the tokens
+ * returned by sstr_split_next point into src, which must outlive them.
+ *
+ * @param it Iterator to initialize
+ * @param src Characters to split
+ * @param delim Delimiter character
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_split_init(SStrSplitIter *it, SStrView src, char delim);
+
+/**
+ * Start splitting a view on any character of a delimiter set
+ *
+ * The set is turned into a 256-bit bitmap once, here. Sets of up to
+ * SSTR_SPLIT_SET_MAX distinct characters are also matched a block at a
+ * time when SSTR_ENABLE_SIMD is set. An empty set yields src as one token.
+ *
+ * @param it Iterator to initialize
+ * @param src Characters to split
+ * @param delims Delimiter characters, in any order; NUL is allowed
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_split_init_set(SStrSplitIter *it, SStrView src, SStrView delims);
+
+/**
+ * Return the next token of a split
+ *
+ * Tokens are the runs between delimiters, including empty ones, so a
+ * source with n delimiters yields n + 1 tokens: "a,,b," splits on ','
+ * into "a", "", "b" and "".
+ *
+ * @param it Iterator from sstr_split_init or sstr_split_init_set
+ * @param token Set to the next token
+ * @return 1 if a token was returned, 0 when the split is exhausted or an
+ *         argument is NULL
+ */
+int sstr_split_next(SStrSplitIter *it, SStrView *token);
+
+/**
+ * Initialize an arena over a caller-provided block
+ *
+ * @param arena Arena to initialize
+ * @param block Memory block the strings are carved from
+ * @param size Size of the block in bytes
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_arena_init(SStrArena *arena, char *block, size_t size);
+
+/**
+ * Carve a buffer for an empty SStr out of the arena
+ *
+ * Takes capacity + 1 bytes from the top of the arena and initializes s as
+ * sstr_init would. The string stays valid until the arena is reset.
+ *
+ * @param arena Arena to allocate from
+ * @param s SStr to initialize
+ * @param capacity Maximum number of characters, excluding the terminator
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if the arena is too full
+ */
+SStrResult sstr_arena_alloc(SStrArena *arena, SStr *s, size_t capacity);
+
+/**
+ * Grow the most recently allocated string in place
+ *
+ * Only the string at the top of the arena can grow; its content is kept.
+ * A capacity no larger than the current one leaves s unchanged.
+ *
+ * @param arena Arena s was allocated from
+ * @param s SStr at the top of the arena
+ * @param capacity New maximum number of characters
+ * @return SSTR_SUCCESS, SSTR_ERROR_ARGUMENT if s is not at the top of the
+ *         arena, or SSTR_ERROR_OVERFLOW if the arena is too full
+ */
+SStrResult sstr_arena_grow(SStrArena *arena, SStr *s, size_t capacity);
+
+/**
+ * Release every string allocated from the arena at once
+ *
+ * Strings allocated before the reset must no longer be used.
+ *
+ * @param arena Arena to reset
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_arena_reset(SStrArena *arena);
+
+/**
+ * Number of bytes still free in the arena
+ *
+ * An allocation of capacity n needs n + 1 bytes.
+ *
+ * @param arena Arena to query
+ * @return Free bytes, or 0 if arena is NULL
+ */
+size_t sstr_arena_available(const SStrArena *arena);
+
+/**
+ * Initialize an empty interning table over caller-provided storage
+ *
+ * The index keeps at least a quarter of its slots free so probes stay
+ * short: slot_count slots hold up to slot_count - (slot_count + 3) / 4
+ * strings. Each string takes length + 1 bytes of the pool. Pools beyond
+ * UINT32_MAX bytes are used up to that size.
+ *
+ * @param table Table to initialize
+ * @param slots Index storage
+ * @param slot_count Number of slots, a power of two
+ * @param pool Storage for the characters
+ * @param pool_size Size of the pool in bytes
+ * @return SSTR_SUCCESS, or SSTR_ERROR_ARGUMENT if slot_count is not a
+ *         power of two
+ */
+SStrResult sstr_intern_init(SStrInternTable *table, SStrInternSlot *slots, size_t slot_count,
+                            char *pool, size_t pool_size);
+
+/**
+ * Initialize an empty interning table whose index hashes with a seed
+ *
+ * As sstr_intern_init, which uses seed 0. Pass a secret, random seed for
+ * tables fed untrusted keys, so that colliding keys cannot be chosen to
+ * lengthen the probes.
+ *
+ * @param seed Seed passed to sstr_view_hash_seed
+ */
+SStrResult sstr_intern_init_seed(SStrInternTable *table, SStrInternSlot *slots,
+                                 size_t slot_count, char *pool, size_t pool_size, uint64_t seed);
+
+/**
+ * Intern a string
+ *
+ * Returns the table's copy of s, adding it first if the table has none.
+ * Interned views stay valid until the table is reset and are terminated,
+ * so .data is also a C string. Two strings interned in the same table are
+ * equal exactly when their views have the same data pointer.
+ *
+ * @param table Table to intern into
+ * @param s Characters to intern; may contain NUL
+ * @param out Set to the interned copy
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if s is new and the index
+ *         or the pool is full
+ */
+SStrResult sstr_intern(SStrInternTable *table, SStrView s, SStrView *out);
+
+/**
+ * Look up a string without adding it
+ *
+ * @param table Table to search
+ * @param s Characters to look up
+ * @param out Set to the interned copy when found
+ * @return 1 if s is interned, 0 if not or an argument is NULL
+ */
+int sstr_intern_find(const SStrInternTable *table, SStrView s, SStrView *out);
+
+/**
+ * Remove every string from a table, invalidating the interned views
+ *
+ * @param table Table to reset
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_intern_reset(SStrInternTable *table);
+
+/**
+ * Initialize an empty sink over a caller-provided buffer
+ *
+ * The buffer holds at most buffer_size - 1 bytes between flushes; the last
+ * byte keeps sink->buffer terminated.
+ *
+ * @param sink Sink to initialize
+ * @param buffer Buffer for pending output
+ * @param buffer_size Size of the buffer in bytes, at least 2
+ * @param flush Callback receiving the output
+ * @param context Passed to every flush call; may be NULL
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if buffer_size is below 2
+ */
+SStrResult sstr_sink_init(SStrSink *sink, char *buffer, size_t buffer_size, SStrSinkFlush flush,
+                          void *context);
+
+/**
+ * Write bytes to a sink
+ *
+ * Bytes that fit are buffered. Otherwise the buffered bytes are flushed
+ * first, and a write at least as large as the buffer goes to the callback
+ * directly rather than being copied through it.
+ *
+ * @param sink Sink to write to
+ * @param data Bytes to write; may contain NUL
+ * @param length Number of bytes
+ * @return SSTR_SUCCESS or the failing flush's result; if flushing the
+ *         buffered bytes fails, they stay buffered and nothing is written
+ */
+SStrResult sstr_sink_write(SStrSink *sink, const char *data, size_t length);
+
+/**
+ * Write a C string or a view to a sink, as sstr_sink_write
+ *
+ * @param sink Sink to write to
+ * @param src String to write
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_sink_append(SStrSink *sink, const char *src);
+SStrResult sstr_sink_append_view(SStrSink *sink, SStrView src);
+
+#if SSTR_ENABLE_FORMAT
+/**
+ * Format onto a sink (printf-style)
+ *
+ * Output that does not fit after the buffered bytes is formatted again
+ * after flushing them. Output longer than the whole buffer is streamed
+ * through it by the native engine in full-buffer batches; when
+ * SSTR_NATIVE_FORMAT is off, or the format needs the libc fallback, such
+ * output returns SSTR_ERROR_OVERFLOW instead.
+ *
+ * @param sink Sink to write to
+ * @param fmt Format string, validated as for sstr_format
+ * @param ... Format arguments
+ * @return Number of characters written or negative error code. A flush
+ *         failing part-way through streamed output returns its error with
+ *         the earlier batches already delivered.
+ */
+int sstr_sink_format(SStrSink *sink, const char *fmt, ...);
+int sstr_sink_vformat(SStrSink *sink, const char *fmt, va_list args);
+#endif
+
+/**
+ * Hand any buffered bytes to the flush callback
+ *
+ * Nothing is called when the buffer is empty. Bytes stay buffered until a
+ * write no longer fits or this is called, so call it after the last write.
+ *
+ * @param sink Sink to flush
+ * @return SSTR_SUCCESS or the callback's result; on failure the bytes
+ *         stay buffered
+ */
+SStrResult sstr_sink_flush(SStrSink *sink);
+
+/**
+ * Initialize an empty chain over caller-provided storage
+ *
+ * @param chain Chain to initialize
+ * @param segments Segment storage
+ * @param segment_count Number of segments
+ * @param scratch Buffer for copied pieces
+ * @param scratch_size Size of the scratch buffer in bytes
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_chain_init(SStrChain *chain, SStrView *segments, size_t segment_count,
+                           char *scratch, size_t scratch_size);
+
+/**
+ * Append a piece to a chain
+ *
+ * Pieces of up to SSTR_CHAIN_COPY_MAX bytes are copied into the scratch
+ * buffer while it has room; consecutive copies share one segment. Longer
+ * pieces are referenced, not copied, so their characters must stay
+ * unchanged until the chain is written out. A piece that directly follows
+ * the previous segment in memory extends it.
+ *
+ * @param chain Chain to append to
+ * @param piece Characters to append
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if a new segment is needed
+ *         and the segment array is full
+ */
+SStrResult sstr_chain_append_view(SStrChain *chain, SStrView piece);
+
+/**
+ * Append a C string or the content of an SStr, as sstr_chain_append_view
+ *
+ * @param chain Chain to append to
+ * @param src String to append
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_chain_append(SStrChain *chain, const char *src);
+SStrResult sstr_chain_append_sstr(SStrChain *chain, const SStr *src);
+
+/**
+ * Append a copy of a piece, whatever its length
+ *
+ * For characters that will not outlive the chain, such as a header
+ * formatted on the stack.
+ *
+ * @param chain Chain to append to
+ * @param piece Characters to copy
+ * @return SSTR_SUCCESS, or SSTR_ERROR_OVERFLOW if the scratch buffer or
+ *         the segment array is full
+ */
+SStrResult sstr_chain_append_copy(SStrChain *chain, SStrView piece);
+
+/**
+ * Drop bytes from the front of a chain, as after a short writev
+ *
+ * Consuming everything leaves the chain empty and ready for reuse.
+ *
+ * @param chain Chain to consume from
+ * @param bytes Number of bytes written out
+ * @return SSTR_SUCCESS, or SSTR_ERROR_ARGUMENT if bytes exceeds the
+ *         chain's length
+ */
+SStrResult sstr_chain_consume(SStrChain *chain, size_t bytes);
+
+/**
+ * Remove every segment and copied piece from a chain
+ *
+ * @param chain Chain to reset
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_chain_reset(SStrChain *chain);
+
+/**
+ * Copy the bytes of a chain into an SStr, replacing its content
+ *
+ * dest must not be referenced by the chain. With the SSTR_ERROR policy,
+ * dest is left unchanged if the bytes do not fit.
+ *
+ * @param chain Chain to flatten
+ * @param dest Destination SStr
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_chain_flatten(const SStrChain *chain, SStr *dest);
+
+#if SSTR_ENABLE_IOVEC
+/**
+ * Describe the segments of a chain as iovec entries, without copying
+ *
+ *     size_t n = sstr_chain_iov(&chain, iov, 16);
+ *     ssize_t written = writev(fd, iov, (int)n);
+ *     if (written > 0) sstr_chain_consume(&chain, (size_t)written);
+ *
+ * @param chain Chain to describe
+ * @param iov Entries to fill
+ * @param n Number of entries in iov
+ * @return Entries filled, fewer than the segments if n is smaller; 0 if an
+ *         argument is NULL
+ */
+size_t sstr_chain_iov(const SStrChain *chain, struct iovec *iov, size_t n);
+#endif
+
+#if SSTR_ENABLE_STATS
+/**
+ * Groups of functions counted separately by the statistics
+ */
+typedef enum {
+    SSTR_STATS_COPY,   /* sstr_copy, sstr_copy_n, sstr_copy_view */
+    SSTR_STATS_APPEND, /* sstr_append, _sstr, _view, _many and sstr_concat */
+    SSTR_STATS_FORMAT, /* sstr_format, sstr_append_format and sstr_format_exec */
+    SSTR_STATS_API_COUNT
+} SStrStatsApi;
+
+/**
+ * What sstr_stats_record counts
+ */
+typedef enum {
+    SSTR_STATS_WRITE,     /* A call that wrote bytes (possibly 0) to dest */
+    SSTR_STATS_OVERFLOW,  /* A call rejected with SSTR_ERROR_OVERFLOW */
+    SSTR_STATS_TRUNCATION /* The write that follows was cut short */
+} SStrStatsEvent;
+
+/**
+ * Counters for one SStrStatsApi group
+ */
+typedef struct {
+    uint64_t calls;       /* Writes and overflows */
+    uint64_t bytes;       /* Bytes written, excluding terminators */
+    uint64_t overflows;   /* Calls rejected with SSTR_ERROR_OVERFLOW */
+    uint64_t truncations; /* Calls that kept only part of their output */
+} SStrStatsCounters;
+
+/**
+ * Snapshot of the statistics
+ */
+typedef struct {
+    SStrStatsCounters api[SSTR_STATS_API_COUNT];
+    uint32_t high_water_permille; /* Highest length / capacity after a write, x1000 */
+} SStrStats;
+
+/**
+ * Copy the statistics gathered since start-up or the last reset
+ *
+ * Each counter is read atomically, but not all of them at one instant, so
+ * a snapshot taken while other threads write may be off by their calls.
+ *
+ * @param out Snapshot to fill
+ * @return SSTR_SUCCESS or error code
+ */
+SStrResult sstr_stats_snapshot(SStrStats *out);
+
+/**
+ * Reset all statistics to zero
+ */
+void sstr_stats_reset(void);
+
+/**
+ * Count one event; called by the library, and available to wrappers that
+ * want their own writes counted in a group
+ *
+ * @param api Group to count in
+ * @param event Event to count
+ * @param dest Destination after the write, for the high-water mark, or NULL
+ * @param bytes Bytes written, for SSTR_STATS_WRITE
+ */
+void sstr_stats_record(SStrStatsApi api, SStrStatsEvent event, const SStr *dest, size_t bytes);
+#endif
+
+/**
+ * Variants taking an explicit truncation policy
+ *
+ * Each behaves like the function without the _ex suffix but uses policy
+ * instead of SSTR_DEFAULT_POLICY, so one program can reject overflow on
+ * protocol buffers and truncate log lines. A policy other than SSTR_ERROR or
+ * SSTR_TRUNCATE returns SSTR_ERROR_ARGUMENT. The plain functions keep the
+ * default folded in at compile time and cost nothing extra.
+ */
+SStrResult sstr_copy_ex(SStr *dest, const char *src, SStrTruncationPolicy policy);
+SStrResult sstr_copy_n_ex(SStr *dest, const char *src, size_t src_len, SStrTruncationPolicy policy);
+SStrResult sstr_append_ex(SStr *dest, const char *src, SStrTruncationPolicy policy);
+SStrResult sstr_append_sstr_ex(SStr *dest, const SStr *src, SStrTruncationPolicy policy);
+SStrResult sstr_copy_view_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy);
+SStrResult sstr_append_view_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy);
+SStrResult sstr_append_many_ex(SStr *dest, const SStrView *parts, size_t count,
+                               SStrTruncationPolicy policy);
+SStrResult sstr_concat_ex(SStr *dest, SStrTruncationPolicy policy, ...);
+SStrResult sstr_array_copy_views_ex(SStr *arr, const SStrView *views, size_t n,
+                                    SStrTruncationPolicy policy);
+SStrResult sstr_append_i64_ex(SStr *dest, int64_t value, SStrTruncationPolicy policy);
+SStrResult sstr_append_u64_ex(SStr *dest, uint64_t value, SStrTruncationPolicy policy);
+SStrResult sstr_append_hex_ex(SStr *dest, uint64_t value, size_t min_width, int uppercase,
+                              SStrTruncationPolicy policy);
+SStrResult sstr_append_json_escaped_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy);
+SStrResult sstr_append_hex_bytes_ex(SStr *dest, const void *data, size_t length, int uppercase,
+                                    SStrTruncationPolicy policy);
+SStrResult sstr_append_base64_ex(SStr *dest, const void *data, size_t length,
+                                 SStrTruncationPolicy policy);
+#if SSTR_ENABLE_FORMAT
+int sstr_format_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, ...);
+int sstr_vformat_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, va_list args);
+int sstr_append_format_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, ...);
+int sstr_append_vformat_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt,
+                           va_list args);
+#endif
+
+/**
+ * sstr_concat_ex with the terminating NULL added
+ */
+#define SSTR_CONCAT_EX(dest, policy, ...)                                                          \
+    sstr_concat_ex(dest, policy, __VA_ARGS__, (const char *)NULL)
+
+#if SSTR_ENABLE_FORMAT
+/**
+ * Format a string into an SStr (printf-style)
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param ... Format arguments
+ * @return Number of characters written or negative error code
+ */
+int sstr_format(SStr *dest, const char *fmt, ...);
+
+/**
+ * Format a string into an SStr with va_list
+ *
+ * The output is produced in a single formatting pass whenever possible.
+ * With the SSTR_ERROR policy, dest is left unchanged if the output does
+ * not fit.
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param args Variable argument list
+ * @return Number of characters written or negative error code
+ */
+int sstr_vformat(SStr *dest, const char *fmt, va_list args);
+
+/**
+ * Format a string onto the end of an SStr (printf-style)
+ *
+ * The output is written directly after the current content, against the
+ * remaining capacity, with the same validation as sstr_format. With the
+ * SSTR_ERROR policy, dest is left unchanged if the output does not fit.
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param ... Format arguments
+ * @return Number of characters appended or negative error code
+ */
+int sstr_append_format(SStr *dest, const char *fmt, ...);
+
+/**
+ * Format a string onto the end of an SStr with va_list
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param args Variable argument list
+ * @return Number of characters appended or negative error code
+ */
+int sstr_append_vformat(SStr *dest, const char *fmt, va_list args);
+
+/**
+ * Validate and parse a format string into a reusable program
+ *
+ * Applies the same checks as sstr_format (including SSTR_ALLOWED_SPECIFIERS
+ * when validation is enabled), so executing the program needs neither
+ * validation nor parsing. Only the conversions of the native engine are
+ * accepted.
+ *
+ * @param prog Program to fill in
+ * @param fmt Format string, which must outlive the program
+ * @return SSTR_SUCCESS, SSTR_ERROR_FORMAT for a rejected format, or
+ *         SSTR_ERROR_OVERFLOW if it needs more than SSTR_FORMAT_MAX_OPS steps
+ */
+SStrResult sstr_format_compile(SStrFormatProgram *prog, const char *fmt);
+
+/**
+ * Format a compiled program into an SStr
+ *
+ * @param dest Destination SStr
+ * @param prog Program from sstr_format_compile
+ * @param ... Format arguments
+ * @return Number of characters written or negative error code
+ */
+int sstr_format_exec(SStr *dest, const SStrFormatProgram *prog, ...);
+
+/**
+ * Format a compiled program into an SStr with va_list
+ *
+ * @param dest Destination SStr
+ * @param prog Program from sstr_format_compile
+ * @param args Variable argument list
+ * @return Number of characters written or negative error code
+ */
+int sstr_vformat_exec(SStr *dest, const SStrFormatProgram *prog, va_list args);
+
+/**
+ * Format a string into an SStr without validating the format string
+ *
+ * Only for format strings already known to use allowed specifiers, such
+ * as literals checked at build time by sstr_format_literal.
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param ... Format arguments
+ * @return Number of characters written or negative error code
+ */
+int sstr_format_unchecked(SStr *dest, const char *fmt, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/**
+ * Format a string into an SStr with va_list without validating the format
+ *
+ * @param dest Destination SStr
+ * @param fmt Format string
+ * @param args Variable argument list
+ * @return Number of characters written or negative error code
+ */
+int sstr_vformat_unchecked(SStr *dest, const char *fmt, va_list args);
+
+/**
+ * Format with a string literal checked at build time
+ *
+ *     sstr_format_literal(&s, "id=%d name=%s", id, name);
+ *
+ * On GCC and Clang with optimization enabled, a literal that uses a
+ * specifier outside SSTR_ALLOWED_SPECIFIERS fails to compile, and a
+ * literal proven valid calls sstr_format_unchecked, skipping the runtime
+ * scan. Literals too long or too unusual to check (more than a few hundred
+ * characters, or runs of more than four flags or width digits) and builds
+ * without optimization use sstr_format's runtime validation. On the
+ * checked path the argument types are also checked against the format.
+ *
+ * The format must be a string literal; use sstr_format for any other
+ * format string.
+ */
+#if SSTR_VALIDATE_FORMAT && defined(__GNUC__) && defined(__OPTIMIZE__) &&                          \
+    (!defined(__clang__) || __clang_major__ >= 14)
+
+/* Positions reported by the build-time scanner besides the literal size */
+#define SSTR_FMT_CHECK_BAD     ((size_t)-1) /* Disallowed specifier */
+#define SSTR_FMT_CHECK_UNKNOWN ((size_t)-2) /* Cannot be decided at build time */
+
+/* Character classes of the scanner */
+#define SSTR_FMT_CLASS_LITERAL 0
+#define SSTR_FMT_CLASS_FLAG    1
+#define SSTR_FMT_CLASS_DIGIT   2
+
+/* The scanner mirrors the runtime validator with straight-line code only,
+ * so that the compiler can fold it completely for a literal */
+#define SSTR_FMT_CHECK_FN static inline __attribute__((always_inline, pure))
+
+SSTR_FMT_CHECK_FN int sstr_fmt_check_char(const char *f, size_t n, size_t i)
+{
+    return i < n ? (unsigned char)f[i] : 0;
+}
+
+SSTR_FMT_CHECK_FN int sstr_fmt_check_is(int c, int cls)
+{
+    if (cls == SSTR_FMT_CLASS_FLAG) {
+        return c == '-' || c == '+' || c == '0' || c == ' ' || c == '#';
+    }
+    if (cls == SSTR_FMT_CLASS_DIGIT) {
+        return c >= '0' && c <= '9';
+    }
+    return c != '\0' && c != '%';
+}
+
+/* Skip up to four characters of one class */
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check_skip4(const char *f, size_t n, size_t i, int cls)
+{
+    if (i < n && sstr_fmt_check_is(sstr_fmt_check_char(f, n, i), cls)) {
+        i++;
+    }
+    if (i < n && sstr_fmt_check_is(sstr_fmt_check_char(f, n, i), cls)) {
+        i++;
+    }
+    if (i < n && sstr_fmt_check_is(sstr_fmt_check_char(f, n, i), cls)) {
+        i++;
+    }
+    if (i < n && sstr_fmt_check_is(sstr_fmt_check_char(f, n, i), cls)) {
+        i++;
+    }
+    return i;
+}
+
+/* Skip a bounded run of flags or digits; a longer run is undecided */
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check_run(const char *f, size_t n, size_t i, int cls)
+{
+    i = sstr_fmt_check_skip4(f, n, i, cls);
+    if (i < n && sstr_fmt_check_is(sstr_fmt_check_char(f, n, i), cls)) {
+        return SSTR_FMT_CHECK_UNKNOWN;
+    }
+    return i;
+}
+
+/* Check one conversion specification; i is just past the '%' */
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check_conversion(const char *f, size_t n, size_t i)
+{
+    int c = sstr_fmt_check_char(f, n, i);
+    if (c == '%') {
+        return i + 1;
+    }
+    if (c == '\0') {
+        return SSTR_FMT_CHECK_BAD;
+    }
+
+    i = sstr_fmt_check_run(f, n, i, SSTR_FMT_CLASS_FLAG);
+    i = sstr_fmt_check_run(f, n, i, SSTR_FMT_CLASS_DIGIT);
+    if (sstr_fmt_check_char(f, n, i) == '.') {
+        i = sstr_fmt_check_run(f, n, i + 1, SSTR_FMT_CLASS_DIGIT);
+    }
+    if (i >= n) {
+        return i;
+    }
+
+    c = sstr_fmt_check_char(f, n, i);
+    if (c == 'h' || c == 'l' || c == 'j' || c == 'z' || c == 't' || c == 'L') {
+        i += ((c == 'h' || c == 'l') && sstr_fmt_check_char(f, n, i + 1) == c) ? 2 : 1;
+    }
+
+    c = sstr_fmt_check_char(f, n, i);
+    if (c == '\0' || __builtin_strchr(SSTR_ALLOWED_SPECIFIERS, c) == NULL) {
+        return SSTR_FMT_CHECK_BAD;
+    }
+
+    return i + 1;
+}
+
+/* Advance over up to eight literal characters or one conversion */
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check_step(const char *f, size_t n, size_t i)
+{
+    int c = sstr_fmt_check_char(f, n, i);
+
+    if (i >= n) {
+        return i;
+    }
+    if (c == '\0') {
+        return n;
+    }
+    if (c == '%') {
+        return sstr_fmt_check_conversion(f, n, i + 1);
+    }
+
+    i = sstr_fmt_check_skip4(f, n, i, SSTR_FMT_CLASS_LITERAL);
+    return sstr_fmt_check_skip4(f, n, i, SSTR_FMT_CLASS_LITERAL);
+}
+
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check_step8(const char *f, size_t n, size_t i)
+{
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    i = sstr_fmt_check_step(f, n, i);
+    return sstr_fmt_check_step(f, n, i);
+}
+
+/* Scan a literal of size n (including its terminator). Returns n if it is
+ * valid, SSTR_FMT_CHECK_BAD if it is not, anything else if undecided. */
+SSTR_FMT_CHECK_FN size_t sstr_fmt_check(const char *f, size_t n)
+{
+    size_t i = 0;
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    i = sstr_fmt_check_step8(f, n, i);
+    return sstr_fmt_check_step8(f, n, i);
+}
+
+/* Never defined: a call that survives optimization fails the build */
+extern int sstr_format_rejected_literal(void) __attribute__((
+    error("sstr_format_literal: format uses a specifier outside SSTR_ALLOWED_SPECIFIERS")));
+
+#define SSTR_FMT_FIRST(first, ...) first
+
+#define sstr_format_literal(dest, ...)                                                             \
+    SSTR_FORMAT_LITERAL_CHECKED(dest, SSTR_FMT_FIRST(__VA_ARGS__, 0), __VA_ARGS__)
+
+#define SSTR_FORMAT_LITERAL_CHECKED(dest, lit, ...)                                                \
+    __extension__({                                                                                \
+        size_t sstr_fmt_verdict = sstr_fmt_check("" lit "", sizeof(lit));                          \
+        int sstr_fmt_known = __builtin_constant_p(sstr_fmt_verdict);                               \
+        (sstr_fmt_known && sstr_fmt_verdict == sizeof(lit))                                        \
+            ? sstr_format_unchecked(dest, __VA_ARGS__)                                             \
+            : (sstr_fmt_known && sstr_fmt_verdict == SSTR_FMT_CHECK_BAD)                           \
+                  ? sstr_format_rejected_literal()                                                 \
+                  : sstr_format(dest, __VA_ARGS__);                                                \
+    })
+
+#else
+#define sstr_format_literal(dest, ...) sstr_format(dest, __VA_ARGS__)
+#endif
+#endif /* SSTR_ENABLE_FORMAT */
+
+#if SSTR_INLINE_FAST_PATHS && !SSTR_ENABLE_STATS && !defined(__CPROVER)
+#include <string.h>
+
+/*
+ * Inline fast paths for the length-known operations
+ *
+ * Each handles a valid destination with room for the whole source at the call
+ * site and leaves NULL arguments, overflow and growth to the library function,
+ * which the parenthesized call reaches past the macro of the same name.
+ */
+static inline SStrResult sstr_clear_fast(SStr *s)
+{
+    if (s != NULL && s->data != NULL) {
+        s->length = 0;
+        s->data[0] = '\0';
+        return SSTR_SUCCESS;
+    }
+    return (sstr_clear)(s);
+}
+
+static inline SStrResult sstr_copy_n_fast(SStr *dest, const char *src, size_t src_len)
+{
+    if (dest != NULL && dest->data != NULL && src != NULL && src_len <= dest->capacity) {
+        memcpy(dest->data, src, src_len);
+        dest->data[src_len] = '\0';
+        dest->length = (sstr_len_t)src_len;
+        return SSTR_SUCCESS;
+    }
+    return (sstr_copy_n)(dest, src, src_len);
+}
+
+static inline SStrResult sstr_copy_view_fast(SStr *dest, SStrView src)
+{
+    if (dest != NULL && dest->data != NULL && src.data != NULL && src.length <= dest->capacity) {
+        /* The view may point into the destination itself */
+        memmove(dest->data, src.data, src.length);
+        dest->data[src.length] = '\0';
+        dest->length = (sstr_len_t)src.length;
+        return SSTR_SUCCESS;
+    }
+    return (sstr_copy_view)(dest, src);
+}
+
+static inline SStrResult sstr_append_sstr_fast(SStr *dest, const SStr *src)
+{
+    if (dest != NULL && dest->data != NULL && src != NULL && src->data != NULL &&
+        src->length <= (size_t)dest->capacity - dest->length) {
+        size_t length = src->length;
+        memcpy(dest->data + dest->length, src->data, length);
+        dest->length = (sstr_len_t)(dest->length + length);
+        dest->data[dest->length] = '\0';
+        return SSTR_SUCCESS;
+    }
+    return (sstr_append_sstr)(dest, src);
+}
+
+static inline SStrResult sstr_append_view_fast(SStr *dest, SStrView src)
+{
+    if (dest != NULL && dest->data != NULL && src.data != NULL &&
+        src.length <= (size_t)dest->capacity - dest->length) {
+        memmove(dest->data + dest->length, src.data, src.length);
+        dest->length = (sstr_len_t)(dest->length + src.length);
+        dest->data[dest->length] = '\0';
+        return SSTR_SUCCESS;
+    }
+    return (sstr_append_view)(dest, src);
+}
+
+#define sstr_clear(s)               sstr_clear_fast(s)
+#define sstr_copy_n(dest, src, len) sstr_copy_n_fast(dest, src, len)
+#define sstr_copy_view(dest, src)   sstr_copy_view_fast(dest, src)
+#define sstr_append_sstr(dest, src) sstr_append_sstr_fast(dest, src)
+#define sstr_append_view(dest, src) sstr_append_view_fast(dest, src)
+#endif
 
 #endif /* SSTR_H */
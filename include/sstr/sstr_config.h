@@ -36,6 +36,18 @@
 #define SSTR_MAX_SIZE ((size_t)0x7FFFFFFF)
 #endif
 
+/**
+ * Width of the length and capacity fields of SStr.
+ * 0 uses size_t. 32 or 16 use uint32_t or uint16_t, shrinking the header
+ * to a pointer plus 8 or 4 bytes; capacities are then limited to
+ * 0xFFFFFFFE or 0xFFFE characters (and never more than SSTR_MAX_SIZE for
+ * growable and arena strings), and sstr_init uses only that much of a
+ * larger buffer.
+ */
+#ifndef SSTR_LENGTH_BITS
+#define SSTR_LENGTH_BITS 0
+#endif
+
 /**
  * Format string validation control.
  * When enabled, format strings will be validated to ensure only
@@ -54,6 +66,120 @@
 #define SSTR_ALLOWED_SPECIFIERS "diuxXsc%"
 #endif
 
+/**
+ * Formatting.
+ * Set to 0 to leave out sstr_format and the rest of the printf-style API
+ * (including sstr_sink_format and compiled programs), for firmware that only
+ * copies and appends. Nothing then references vsnprintf, and calling a
+ * format function fails to compile. The integer appenders stay available.
+ */
+#ifndef SSTR_ENABLE_FORMAT
+#define SSTR_ENABLE_FORMAT 1
+#endif
+
+/**
+ * Native formatting engine.
+ * When enabled, sstr_format handles the d,i,u,x,X,s,c and % conversions
+ * (with flags, width, precision and the hh,h,l,ll,z,j,t length modifiers)
+ * itself instead of calling the C library's vsnprintf. A NULL %s argument
+ * is reported as SSTR_ERROR_ARGUMENT.
+ */
+#ifndef SSTR_NATIVE_FORMAT
+#define SSTR_NATIVE_FORMAT 1
+#endif
+
+/**
+ * Fall back to vsnprintf for conversions the native engine does not
+ * implement. This is only reachable when validation is disabled or the
+ * allowed specifiers are widened; set to 0 to keep vsnprintf out of the
+ * link entirely, in which case such conversions return SSTR_ERROR_FORMAT.
+ * vsnprintf is the only part of formatting that consults the locale.
+ */
+#ifndef SSTR_FORMAT_LIBC_FALLBACK
+#define SSTR_FORMAT_LIBC_FALLBACK 1
+#endif
+
+/**
+ * Maximum number of steps in a program built by sstr_format_compile.
+ * Each step is a literal run followed by one conversion, plus one step
+ * for any trailing literal.
+ */
+#ifndef SSTR_FORMAT_MAX_OPS
+#define SSTR_FORMAT_MAX_OPS 16
+#endif
+
+/**
+ * Word-at-a-time string scanning.
+ * When enabled, finding the terminator of a source string reads whole
+ * aligned blocks (AVX2, SSE2 or NEON when the target has them, otherwise
+ * 8-byte words) instead of one byte at a time. Set to 0 to use the plain
+ * byte loop, which is always used under CBMC.
+ */
+#ifndef SSTR_ENABLE_SIMD
+#define SSTR_ENABLE_SIMD 1
+#endif
+
+/**
+ * Growable strings.
+ * When enabled, an SStr can own a buffer obtained from an SStrAllocator
+ * (see sstr_init_growable); appends and formatting then grow it instead of
+ * overflowing. Strings set up with sstr_init keep their fixed capacity.
+ * Disabled by default, in which case SStr has no allocator field and the
+ * library never allocates.
+ */
+#ifndef SSTR_ENABLE_GROWABLE
+#define SSTR_ENABLE_GROWABLE 0
+#endif
+
+/**
+ * Scatter-gather chains.
+ * sstr_chain_append_view copies pieces of up to this many bytes into the
+ * chain's scratch buffer, where neighbours merge into one segment, and
+ * references longer pieces in place. Below this size an extra iovec entry
+ * costs more than the copy.
+ */
+#ifndef SSTR_CHAIN_COPY_MAX
+#define SSTR_CHAIN_COPY_MAX 64
+#endif
+
+/**
+ * struct iovec export for writev and sendmsg.
+ * When enabled, sstr.h includes <sys/uio.h> and declares sstr_chain_iov.
+ * On by default on POSIX systems.
+ */
+#ifndef SSTR_ENABLE_IOVEC
+#if defined(__unix__) || defined(__APPLE__)
+#define SSTR_ENABLE_IOVEC 1
+#else
+#define SSTR_ENABLE_IOVEC 0
+#endif
+#endif
+
+/**
+ * Usage statistics.
+ * When enabled, copies, appends and formats count their calls, bytes written,
+ * overflows and truncations, and track how full destinations get, for reading
+ * with sstr_stats_snapshot. The counters are global and updated with relaxed
+ * atomics, which costs a few atomic adds per call. When disabled (the
+ * default) the counting compiles away entirely.
+ */
+#ifndef SSTR_ENABLE_STATS
+#define SSTR_ENABLE_STATS 0
+#endif
+
+/**
+ * Inline fast paths.
+ * When enabled, sstr.h defines static inline versions of the length-known
+ * operations (sstr_clear, sstr_copy_n, sstr_copy_view, sstr_append_sstr and
+ * sstr_append_view) that handle a valid destination with enough room at the
+ * call site and call the library for everything else, so hot loops inline
+ * without LTO. Results are the same either way. Ignored when statistics are
+ * enabled and under CBMC.
+ */
+#ifndef SSTR_INLINE_FAST_PATHS
+#define SSTR_INLINE_FAST_PATHS 0
+#endif
+
 /**
  * Define format specifiers to handle.
  */
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * Klee Verification Harness for the native sstr_format engine
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stdlib.h>
+#include <assert.h>  /* Include to avoid implicit __assert_fail declaration */
+#include "klee/klee.h"
+
+#ifndef SSTR_ERROR
+#define SSTR_ERROR 0
+#endif
+
+#ifndef SSTR_TRUNCATE
+#define SSTR_TRUNCATE 1
+#endif
+
+#ifndef SSTR_DEFAULT_POLICY
+#define SSTR_DEFAULT_POLICY SSTR_ERROR
+#endif
+
+/* Number of hex digits needed for value */
+static size_t hex_length(unsigned int value) {
+    size_t len = 1;
+
+    /* Use a regular loop for Klee */
+    while (value >= 16u) {
+        value >>= 4;
+        len++;
+    }
+
+    return len;
+}
+
+/* Klee verification harness */
+int main() {
+    /* Create a small buffer for the destination string */
+    const size_t DEST_SIZE = 8;
+    char dest_buffer[DEST_SIZE];
+    SStr dest;
+
+    /* Initialize the destination string */
+    sstr_init(&dest, dest_buffer, DEST_SIZE);
+
+    /* Symbolic value */
+    unsigned int value;
+    klee_make_symbolic(&value, sizeof(value), "value");
+
+    /* Zero-padded to six digits, wider values need up to eight */
+    size_t digits = hex_length(value);
+    size_t expected_len = digits > 6 ? digits : 6;
+
+    /* Call the function under test */
+    int result = sstr_format(&dest, "%06x", value);
+
+    /* Verify post-conditions */
+    if (result >= 0) {
+        klee_assert((size_t)result == expected_len && "Result is the full output length");
+        klee_assert(dest.length <= dest.capacity && "Length is within capacity");
+        klee_assert(dest.data[dest.length] == '\0' && "String is null-terminated");
+
+        if (expected_len <= dest.capacity) {
+            klee_assert(dest.length == expected_len && "Length matches the output");
+        } else {
+            klee_assert(SSTR_DEFAULT_POLICY != SSTR_ERROR &&
+                        "Success on overflow only with TRUNCATE policy");
+        }
+    } else {
+        klee_assert(result == SSTR_ERROR_OVERFLOW && "Only overflow can fail for %x");
+        klee_assert(expected_len > dest.capacity && "Overflow error implies output too long");
+        klee_assert(dest.length == 0 && dest.data[0] == '\0' && "Destination unchanged on overflow");
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * Klee Verification Harness for sstr_to_lower, sstr_to_upper and the sstr_trim functions
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stdlib.h>
+#include <assert.h>  /* Include to avoid implicit __assert_fail declaration */
+#include "klee/klee.h"
+
+/* Reference predicates, independent of the library's helpers */
+static int is_space_test(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static char lower_test(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+static char upper_test(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 32) : c;
+}
+
+/* Klee verification harness */
+int main() {
+    /* Create a small buffer for the string */
+    const size_t BUFFER_SIZE = 10;
+    char buffer[BUFFER_SIZE];
+    SStr str;
+
+    /* Initialize the string */
+    sstr_init(&str, buffer, BUFFER_SIZE);
+
+    /* Symbolic content of a symbolic length */
+    char original[BUFFER_SIZE];
+    klee_make_symbolic(original, BUFFER_SIZE, "original");
+    size_t len;
+    klee_make_symbolic(&len, sizeof(len), "len");
+    klee_assume(len < BUFFER_SIZE);
+    for (size_t i = 0; i < len; i++) {
+        buffer[i] = original[i];
+    }
+    buffer[len] = '\0';
+    str.length = len;
+
+    /* Pick the operation under test */
+    int op;
+    klee_make_symbolic(&op, sizeof(op), "op");
+    klee_assume(op >= 0);
+    klee_assume(op <= 4);
+
+    SStrResult result;
+    if (op == 0) {
+        result = sstr_to_lower(&str);
+    } else if (op == 1) {
+        result = sstr_to_upper(&str);
+    } else if (op == 2) {
+        result = sstr_trim_left(&str);
+    } else if (op == 3) {
+        result = sstr_trim_right(&str);
+    } else {
+        result = sstr_trim(&str);
+    }
+
+    klee_assert(result == SSTR_SUCCESS && "Transform succeeds on a valid string");
+    klee_assert(str.length <= len && "Length never grows");
+    klee_assert(str.data[str.length] == '\0' && "String is null-terminated after transform");
+
+    if (op <= 1) {
+        /* Case conversion keeps the length and changes only ASCII letters */
+        klee_assert(str.length == len && "Case conversion keeps the length");
+        for (size_t i = 0; i < len; i++) {
+            char expected = op == 0 ? lower_test(original[i]) : upper_test(original[i]);
+            klee_assert(str.data[i] == expected && "Character converted correctly");
+        }
+    } else {
+        /* Trimming leaves the slice between the leading and trailing whitespace */
+        size_t start = 0;
+        size_t end = len;
+        if (op != 3) {
+            while (start < len && is_space_test(original[start])) {
+                start++;
+            }
+        }
+        if (op != 2) {
+            while (end > start && is_space_test(original[end - 1])) {
+                end--;
+            }
+        }
+        klee_assert(str.length == end - start && "Trimmed length is correct");
+        for (size_t i = 0; i < str.length; i++) {
+            klee_assert(str.data[i] == original[start + i] && "Trimmed content is preserved");
+        }
+    }
+
+    return 0;
+}
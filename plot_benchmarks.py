@@ -1,6 +1,6 @@
 #!/usr/bin/env python3
 """
-Plot benchmark results from hyperfine outputs
+Plot benchmark results from hyperfine outputs and the sstr_bench size sweep
 """
 
 import json
@@ -106,9 +106,43 @@ def _plot_benchmark_group(ax, results, benchmarks, title):
     # Add a grid for better readability
     ax.grid(axis='y', linestyle='--', alpha=0.7)
 
+def create_sweep_plot(filename, output_filename):
+    """Plot ns/op against source size for each operation in sstr_bench output"""
+    with open(filename, 'r') as f:
+        data = json.load(f)
+
+    operations = {}
+    for result in data['results']:
+        series = operations.setdefault(result['operation'], {})
+        points = series.setdefault(result['command'], [])
+        points.append((result['size'], result['ns_per_op']))
+
+    fig, axes = plt.subplots(len(operations), 1, figsize=(12, 4 * len(operations)), squeeze=False)
+
+    for ax, (operation, series) in zip(axes[:, 0], sorted(operations.items())):
+        for command, points in sorted(series.items()):
+            points.sort()
+            ax.plot([p[0] for p in points], [p[1] for p in points], marker='o', label=command)
+        ax.set_title(f"{operation} (median ns/op)")
+        ax.set_xscale('log', base=2)
+        ax.set_yscale('log')
+        ax.set_xlabel('Source size (bytes)')
+        ax.set_ylabel('ns/op')
+        ax.legend()
+        ax.grid(linestyle='--', alpha=0.7)
+
+    plt.tight_layout()
+    plt.savefig(output_filename)
+    print(f"Plot saved to {output_filename}")
+
 if __name__ == "__main__":
     # Load all benchmark results
     results = load_benchmark_results("results_*.json")
 
     # Create comparison plot
-    create_comparison_plot(results, "benchmark_results.png")
+    if results:
+        create_comparison_plot(results, "benchmark_results.png")
+
+    # Plot the in-process size sweep
+    if os.path.exists("sstr_bench.json"):
+        create_sweep_plot("sstr_bench.json", "sstr_bench_results.png")
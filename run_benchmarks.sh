@@ -1,22 +1,26 @@
 #!/bin/bash
 # Benchmark runner for sstr library
-# Requires hyperfine to be installed: https://github.com/sharkdp/hyperfine
-
-# Check if hyperfine is installed
-if ! command -v hyperfine &> /dev/null; then
-    echo "Error: hyperfine is not installed"
-    echo "Please install it from https://github.com/sharkdp/hyperfine"
-    exit 1
-fi
+# The in-process sstr_bench sweep always runs; the whole-process comparisons
+# additionally need hyperfine: https://github.com/sharkdp/hyperfine
 
 # Build the benchmark executables
 echo "Building benchmarks..."
 mkdir -p build
 cd build
 cmake .. -DSSTR_BUILD_BENCHMARKS=ON
-make bench_copy_n bench_copy_std bench_append_sstr bench_append_std bench_format_sstr bench_format_std
+make sstr_bench bench_copy_n bench_copy_std bench_append_sstr bench_append_std bench_format_sstr bench_format_std bench_policy
 cd ..
 
+echo "Running in-process benchmarks..."
+./build/sstr_bench --output sstr_bench.json
+
+# Check if hyperfine is installed
+if ! command -v hyperfine &> /dev/null; then
+    echo "hyperfine is not installed; skipping whole-process benchmarks"
+    echo "Results are saved in sstr_bench.json."
+    exit 0
+fi
+
 # Define benchmark scenarios
 SMALL_STRING="Hello, world!"
 MEDIUM_STRING="This is a medium-sized string that will be used for benchmarking the string functions"
@@ -75,5 +79,14 @@ hyperfine --warmup 3 \
     --export-json results_format_complex.json \
     --export-csv results_format_complex.csv
 
+echo "Running truncation policy benchmarks..."
+hyperfine --warmup 3 \
+    "./build/bench_policy default" \
+    "./build/bench_policy error" \
+    "./build/bench_policy truncate" \
+    --export-markdown results_policy.md \
+    --export-json results_policy.json \
+    --export-csv results_policy.csv
+
 echo "All benchmarks completed."
 echo "Results are saved in Markdown, JSON, and CSV formats."
@@ -11,7 +11,7 @@ INCLUDE_DIR="./include"
 SRC_DIR="./src"
 KLEE_DIR="./klee"
 BUILD_DIR="./klee-build"
-CLANG_FLAGS="-g -O0 -Xclang -disable-O0-optnone"
+CLANG_FLAGS="-g -O0 -Xclang -disable-O0-optnone -DSSTR_ENABLE_SIMD=0"
 
 # Ensure build directory exists
 mkdir -p "$BUILD_DIR"
@@ -52,6 +52,8 @@ if [ $# -eq 0 ]; then
     run_klee "sstr_init"
     run_klee "sstr_copy"
     run_klee "sstr_append"
+    run_klee "sstr_format"
+    run_klee "sstr_transform"
 else
     # Run only the specified harness
     run_klee "$1"
@@ -12,7 +12,20 @@
 #include "../include/sstr/cbmc_stubs.h"
 #include "../include/sstr/sstr_config.h"
 #include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
+#if SSTR_ENABLE_GROWABLE
+#include <stdlib.h>
+#endif
+
+/* Each operation is written once as an inline helper taking the truncation
+ * policy. The plain entry points pass the compile-time default, which the
+ * compiler folds away; the _ex entry points pass it through from the caller. */
+static int sstr_policy_valid(SStrTruncationPolicy policy)
+{
+    return policy == SSTR_ERROR || policy == SSTR_TRUNCATE;
+}
 
 SStrResult sstr_init(SStr *s, char *buffer, size_t buffer_size)
 {
@@ -27,10 +40,18 @@ SStrResult sstr_init(SStr *s, char *buffer, size_t buffer_size)
         return SSTR_ERROR_OVERFLOW;
     }
 
+    /* Narrow length fields cannot describe the whole of a larger buffer */
+    if (buffer_size > SSTR_LENGTH_MAX) {
+        buffer_size = SSTR_LENGTH_MAX;
+    }
+
     s->data = buffer;
     s->capacity = buffer_size - 1; /* Reserve space for null terminator */
     s->length = 0;
     s->data[0] = '\0';
+#if SSTR_ENABLE_GROWABLE
+    s->allocator = NULL;
+#endif
 
     /* Example CBMC verification: Check a property with __CPROVER_assert */
     __CPROVER_assert(s->capacity == buffer_size - 1, "Capacity is set correctly");
@@ -40,7 +61,9 @@ SStrResult sstr_init(SStr *s, char *buffer, size_t buffer_size)
     return SSTR_SUCCESS;
 }
 
-SStrResult sstr_clear(SStr *s)
+/* The functions with an SSTR_INLINE_FAST_PATHS version are defined with
+ * parenthesized names so the macros of the same name do not expand */
+SStrResult(sstr_clear)(SStr *s)
 {
     if (s == NULL || s->data == NULL) {
         return SSTR_ERROR_NULL;
@@ -52,243 +75,2529 @@ SStrResult sstr_clear(SStr *s)
     return SSTR_SUCCESS;
 }
 
-/* Get the length of a string with an explicit maximum to check
- * Returns SSTR_SUCCESS if a null terminator is found within max_len
- * Sets out_len to the length (not including null terminator)
- * Returns SSTR_ERROR_OVERFLOW if no null terminator is found within max_len
- *
- * Implementation is designed to be CBMC-verifiable with bounded loops
- */
-static SStrResult sstr_bounded_strlen(const char *str, size_t max_len, size_t *out_len)
+SStrResult sstr_reserve(SStr *s, size_t capacity)
 {
-    if (str == NULL || out_len == NULL) {
+    if (s == NULL || s->data == NULL) {
         return SSTR_ERROR_NULL;
     }
 
-    /* For CBMC verification, limit the maximum length to check
-     * This allows CBMC to finish verification in reasonable time */
-#ifdef __CPROVER
-    /* When running under CBMC verification, assume small buffer sizes */
-    __CPROVER_assume(max_len <= 10);
-
-    /* Important: Make sure the string pointer is valid for reading */
-    __CPROVER_assume(__CPROVER_r_ok(str, max_len));
-#endif
-
-    /* Safety check for any null pointer dereference */
-    __CPROVER_assert(str != NULL, "String pointer is not null");
+    if (capacity <= s->capacity) {
+        return SSTR_SUCCESS;
+    }
 
-    /* Use a bounded for loop with explicit limit for CBMC */
-    for (size_t i = 0; i < max_len; i++) {
-        /* For each index, ensure we can safely read this memory location */
-#ifdef __CPROVER
-        __CPROVER_assert(__CPROVER_r_ok(str + i, 1), "String access is safe");
-#endif
+#if SSTR_ENABLE_GROWABLE
+    if (s->allocator != NULL && capacity <= SSTR_CAPACITY_MAX) {
+        /* Double the buffer so that a run of appends costs amortized O(1) */
+        size_t grown = s->capacity < SSTR_CAPACITY_MAX / 2 ? (size_t)s->capacity * 2 + 1
+                                                           : SSTR_CAPACITY_MAX;
+        if (grown < capacity) {
+            grown = capacity;
+        }
 
-        if (str[i] == '\0') {
-            *out_len = i;
-            return SSTR_SUCCESS;
+        char *data = (char *)s->allocator->resize(s->allocator->ctx, s->data, s->capacity + 1,
+                                                  grown + 1);
+        if (data == NULL) {
+            return SSTR_ERROR_OVERFLOW;
         }
+
+        s->data = data;
+        s->capacity = grown;
+        return SSTR_SUCCESS;
     }
+#endif
 
-    /* No null terminator found within bounds */
     return SSTR_ERROR_OVERFLOW;
 }
 
-SStrResult sstr_copy(SStr *dest, const char *src)
+#if SSTR_ENABLE_GROWABLE
+static void *sstr_heap_resize(void *ctx, void *ptr, size_t old_size, size_t new_size)
 {
-    if (dest == NULL || dest->data == NULL) {
-        return SSTR_ERROR_NULL;
+    (void)ctx;
+    (void)old_size;
+
+    if (new_size == 0) {
+        free(ptr);
+        return NULL;
     }
 
-    if (src == NULL) {
+    return realloc(ptr, new_size);
+}
+
+const SStrAllocator sstr_heap_allocator = {sstr_heap_resize, NULL};
+
+SStrResult sstr_init_growable(SStr *s, const SStrAllocator *allocator, size_t capacity)
+{
+    if (s == NULL || allocator == NULL || allocator->resize == NULL) {
         return SSTR_ERROR_NULL;
     }
 
-#ifdef __CPROVER
-    /* For CBMC verification, use fixed small values to allow tractable verification */
-    __CPROVER_assume(dest->capacity <= 10);
+    if (capacity > SSTR_CAPACITY_MAX) {
+        return SSTR_ERROR_OVERFLOW;
+    }
 
-    /* Use CBMC's built-in primitives for memory safety checks */
-    /* Ensure the src pointer can be read for up to 'capacity+1' bytes */
-    __CPROVER_assume(__CPROVER_r_ok(src, dest->capacity + 1));
+    char *data = (char *)allocator->resize(allocator->ctx, NULL, 0, capacity + 1);
+    if (data == NULL) {
+        return SSTR_ERROR_OVERFLOW;
+    }
 
-    /* Ensure the dest->data pointer can be written for up to 'capacity+1' bytes */
-    __CPROVER_assume(__CPROVER_w_ok(dest->data, dest->capacity + 1));
-#endif
+    s->data = data;
+    s->capacity = capacity;
+    s->length = 0;
+    s->data[0] = '\0';
+    s->allocator = allocator;
 
-    /* Ensure capacity is reasonable before proceeding */
-    __CPROVER_assert(dest->capacity < SIZE_MAX, "Destination capacity is reasonable");
+    return SSTR_SUCCESS;
+}
 
-    /* Use a bounded check for string length */
-    size_t src_len;
-    SStrResult result = sstr_bounded_strlen(src, dest->capacity + 1, &src_len);
+SStrResult sstr_free(SStr *s)
+{
+    if (s == NULL) {
+        return SSTR_ERROR_NULL;
+    }
 
-    /* If source has no null terminator within maximum bounds, handle according to policy */
-    if (result == SSTR_ERROR_OVERFLOW) {
-        if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
-            return SSTR_ERROR_OVERFLOW;
-        }
-        src_len = dest->capacity;
+    if (s->allocator == NULL) {
+        return SSTR_SUCCESS;
     }
 
-    /* Check if source fits in destination */
-    if (src_len > dest->capacity) {
-        if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
-            return SSTR_ERROR_OVERFLOW;
-        }
-        src_len = dest->capacity;
+    if (s->data != NULL) {
+        s->allocator->resize(s->allocator->ctx, s->data, s->capacity + 1, 0);
     }
 
-    /* Double-check bounds before memory operations */
-    __CPROVER_assert(src_len <= dest->capacity, "Source length is within destination capacity");
+    s->data = NULL;
+    s->capacity = 0;
+    s->length = 0;
 
-    /* Use a loop for CBMC verification instead of memcpy
-     * This gives CBMC explicit bounds to verify */
-#ifdef __CPROVER
-    for (size_t i = 0; i < src_len; i++) {
-        /* Verify each memory access is safe */
-        __CPROVER_assert(__CPROVER_r_ok(src + i, 1), "Source read is safe");
-        __CPROVER_assert(__CPROVER_w_ok(dest->data + i, 1), "Destination write is safe");
+    return SSTR_SUCCESS;
+}
+#endif
 
-        dest->data[i] = src[i];
-    }
+#if SSTR_ENABLE_STATS
+#if defined(__ATOMIC_RELAXED)
+#define SSTR_STATS_ADD(counter, n) __atomic_fetch_add(&(counter), (n), __ATOMIC_RELAXED)
+#define SSTR_STATS_LOAD(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define SSTR_STATS_STORE(counter, value) __atomic_store_n(&(counter), (value), __ATOMIC_RELAXED)
+#define SSTR_STATS_RAISE(counter, seen, value)                                                     \
+    __atomic_compare_exchange_n(&(counter), &(seen), (value), 1, __ATOMIC_RELAXED,               \
+                                __ATOMIC_RELAXED)
 #else
-    memcpy(dest->data, src, src_len);
+/* Without the GCC atomic builtins the counters are only exact when a single
+ * thread uses the library */
+#define SSTR_STATS_ADD(counter, n) ((counter) += (n))
+#define SSTR_STATS_LOAD(counter) (counter)
+#define SSTR_STATS_STORE(counter, value) ((counter) = (value))
+#define SSTR_STATS_RAISE(counter, seen, value) ((counter) = (value), 1)
 #endif
 
-    /* Ensure null termination */
-    dest->data[src_len] = '\0';
-    dest->length = src_len;
+static SStrStats sstr_stats;
 
-    return SSTR_SUCCESS;
+void sstr_stats_record(SStrStatsApi api, SStrStatsEvent event, const SStr *dest, size_t bytes)
+{
+    if ((unsigned)api >= SSTR_STATS_API_COUNT) {
+        return;
+    }
+
+    SStrStatsCounters *counters = &sstr_stats.api[api];
+
+    switch (event) {
+    case SSTR_STATS_WRITE:
+        SSTR_STATS_ADD(counters->calls, 1);
+        SSTR_STATS_ADD(counters->bytes, (uint64_t)bytes);
+        if (dest != NULL && dest->capacity > 0) {
+            uint32_t fill = (uint32_t)((uint64_t)dest->length * 1000 / dest->capacity);
+            uint32_t seen = SSTR_STATS_LOAD(sstr_stats.high_water_permille);
+            while (fill > seen && !SSTR_STATS_RAISE(sstr_stats.high_water_permille, seen, fill)) {
+            }
+        }
+        break;
+    case SSTR_STATS_OVERFLOW:
+        SSTR_STATS_ADD(counters->calls, 1);
+        SSTR_STATS_ADD(counters->overflows, 1);
+        break;
+    case SSTR_STATS_TRUNCATION:
+        SSTR_STATS_ADD(counters->truncations, 1);
+        break;
+    }
 }
 
-SStrResult sstr_copy_n(SStr *dest, const char *src, size_t src_len)
+SStrResult sstr_stats_snapshot(SStrStats *out)
 {
-    if (dest == NULL || dest->data == NULL || src == NULL) {
+    if (out == NULL) {
         return SSTR_ERROR_NULL;
     }
 
-    if (src_len > dest->capacity) {
-        /* Get truncation policy at runtime - we will respect compile-time policy here
-         * The policy could have been changed after the library was compiled */
-#if SSTR_DEFAULT_POLICY == SSTR_ERROR
-        return SSTR_ERROR_OVERFLOW;
-#else
-        size_t copy_len = dest->capacity;
-        memcpy(dest->data, src, copy_len);
-        dest->data[copy_len] = '\0';
-        dest->length = copy_len;
-#endif
-    } else {
-        memcpy(dest->data, src, src_len);
-        dest->data[src_len] = '\0';
-        dest->length = src_len;
+    for (size_t i = 0; i < SSTR_STATS_API_COUNT; i++) {
+        out->api[i].calls = SSTR_STATS_LOAD(sstr_stats.api[i].calls);
+        out->api[i].bytes = SSTR_STATS_LOAD(sstr_stats.api[i].bytes);
+        out->api[i].overflows = SSTR_STATS_LOAD(sstr_stats.api[i].overflows);
+        out->api[i].truncations = SSTR_STATS_LOAD(sstr_stats.api[i].truncations);
     }
+    out->high_water_permille = SSTR_STATS_LOAD(sstr_stats.high_water_permille);
 
     return SSTR_SUCCESS;
 }
 
-SStrResult sstr_append(SStr *dest, const char *src)
+void sstr_stats_reset(void)
 {
-    if (dest == NULL || dest->data == NULL) {
-        return SSTR_ERROR_NULL;
+    for (size_t i = 0; i < SSTR_STATS_API_COUNT; i++) {
+        SSTR_STATS_STORE(sstr_stats.api[i].calls, 0);
+        SSTR_STATS_STORE(sstr_stats.api[i].bytes, 0);
+        SSTR_STATS_STORE(sstr_stats.api[i].overflows, 0);
+        SSTR_STATS_STORE(sstr_stats.api[i].truncations, 0);
     }
+    SSTR_STATS_STORE(sstr_stats.high_water_permille, 0);
+}
 
-    if (src == NULL) {
-        return SSTR_ERROR_NULL;
-    }
+/* Counts one event for a group, e.g. SSTR_STAT(COPY, WRITE, dest, n) */
+#define SSTR_STAT(api, event, dest, bytes)                                                         \
+    sstr_stats_record(SSTR_STATS_##api, SSTR_STATS_##event, dest, bytes)
+#else
+#define SSTR_STAT(api, event, dest, bytes) ((void)0)
+#endif
 
-#ifdef __CPROVER
-    /* For CBMC verification, limit capacity and length to avoid state explosion */
-    __CPROVER_assume(dest->capacity <= 10);
-    __CPROVER_assume(dest->length <= dest->capacity);
+/* Toggles the case bit of c if it lies in [first, first + 25] */
+static inline unsigned char sstr_ascii_case_flip(unsigned char c, unsigned char first)
+{
+    return (unsigned char)(c - first) < 26 ? (unsigned char)(c ^ 0x20) : c;
+}
 
-    /* Calculate available space only after constraining length/capacity */
-    size_t available = dest->capacity - dest->length;
+/* ASCII whitespace, as isspace in the C locale */
+static inline int sstr_ascii_space(unsigned char c)
+{
+    return c == ' ' || (unsigned char)(c - '\t') < 5;
+}
 
-    /* Use CBMC's built-in primitives for memory safety checks */
-    /* Ensure the src pointer can be read for up to 'available+1' bytes */
-    __CPROVER_assume(__CPROVER_r_ok(src, available + 1));
+/* Tests byte c in a 256-bit set of bytes */
+static inline int sstr_map_has(const unsigned char *map, unsigned char c)
+{
+    return (map[c >> 3] >> (c & 7)) & 1;
+}
 
-    /* Ensure the dest->data pointer can be written for the appropriate range */
-    __CPROVER_assume(__CPROVER_w_ok(dest->data + dest->length, available + 1));
+/* Bytes a JSON string cannot hold unescaped: '"', '\\' and controls */
+static inline int sstr_json_special(unsigned char c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/* Word-at-a-time scanning
+ *
+ * The kernels below read whole aligned blocks, so a block holding the
+ * terminator may also hold bytes past it. Reads past the terminator stay
+ * within the aligned block or stride that holds it, which never spans a
+ * page, and no read extends beyond max_len, so this never touches a page
+ * the byte loop could not. It can still read past the end of the source
+ * object, which is why address sanitizing is disabled for these functions.
+ */
+#if !defined(__CPROVER) && SSTR_ENABLE_SIMD
+#define SSTR_SCAN_WORDS 1
+#else
+#define SSTR_SCAN_WORDS 0
 #endif
 
-    /* Verify length is within capacity */
-    __CPROVER_assert(dest->length <= dest->capacity, "Destination length is within capacity");
+#if SSTR_SCAN_WORDS
 
-    size_t available = dest->capacity - dest->length;
+#if defined(__SANITIZE_ADDRESS__)
+#define SSTR_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SSTR_NO_SANITIZE_ADDRESS __attribute__((no_sanitize("address")))
+#endif
+#endif
+#ifndef SSTR_NO_SANITIZE_ADDRESS
+#define SSTR_NO_SANITIZE_ADDRESS
+#endif
 
-    /* Use a bounded check for string length */
-    size_t src_len;
-    SStrResult result = sstr_bounded_strlen(src, available + 1, &src_len);
+/* One block per target: load it, flag its zero bytes, combine flags and
+ * test whether any are set */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SSTR_SCAN_BLOCK 32
+typedef __m256i sstr_block;
 
-    /* If source has no null terminator within bounds, handle according to policy */
-    if (result == SSTR_ERROR_OVERFLOW) {
-        if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
-            return SSTR_ERROR_OVERFLOW;
-        }
-        src_len = available;
-    }
+static inline SSTR_NO_SANITIZE_ADDRESS sstr_block sstr_block_load(const unsigned char *p)
+{
+    return _mm256_load_si256((const __m256i *)(const void *)p);
+}
 
-    /* Check if source fits in destination's available space */
-    if (src_len > available) {
-        if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
-            return SSTR_ERROR_OVERFLOW;
-        }
-        src_len = available;
-    }
+static inline void sstr_block_store(unsigned char *q, sstr_block v)
+{
+    _mm256_storeu_si256((__m256i *)(void *)q, v);
+}
 
-    /* CBMC assertion: source length is within available space */
-    __CPROVER_assert(src_len <= available, "Source length is within available capacity");
+static inline sstr_block sstr_block_nul(sstr_block v)
+{
+    return _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+}
 
-    /* Use a loop for CBMC verification instead of memcpy
-     * This gives CBMC explicit bounds to verify */
-#ifdef __CPROVER
-    for (size_t i = 0; i < src_len; i++) {
-        /* Verify each memory access is safe */
-        __CPROVER_assert(__CPROVER_r_ok(src + i, 1), "Source read is safe");
-        __CPROVER_assert(__CPROVER_w_ok(dest->data + dest->length + i, 1),
-                         "Destination write is safe");
+static inline sstr_block sstr_block_or(sstr_block a, sstr_block b)
+{
+    return _mm256_or_si256(a, b);
+}
 
-        __CPROVER_assert(i < src_len, "Append index is within source length");
-        __CPROVER_assert(dest->length + i < dest->capacity,
-                         "Append index is within destination capacity");
-        dest->data[dest->length + i] = src[i];
-    }
-#else
-    memcpy(dest->data + dest->length, src, src_len);
-#endif
+static inline int sstr_block_any(sstr_block flags)
+{
+    return _mm256_movemask_epi8(flags) != 0;
+}
 
-    dest->length += src_len;
-    dest->data[dest->length] = '\0';
+static inline sstr_block sstr_block_loadu(const unsigned char *p)
+{
+    return _mm256_loadu_si256((const __m256i *)(const void *)p);
+}
 
-    return SSTR_SUCCESS;
+static inline sstr_block sstr_block_splat(unsigned char c)
+{
+    return _mm256_set1_epi8((char)c);
 }
 
-SStrResult sstr_append_sstr(SStr *dest, const SStr *src)
+static inline sstr_block sstr_block_eq(sstr_block v, sstr_block pattern)
 {
-    if (dest == NULL || dest->data == NULL || src == NULL || src->data == NULL) {
-        return SSTR_ERROR_NULL;
-    }
+    return _mm256_cmpeq_epi8(v, pattern);
+}
 
-    size_t available = dest->capacity - dest->length;
+static inline sstr_block sstr_block_and(sstr_block a, sstr_block b)
+{
+    return _mm256_and_si256(a, b);
+}
 
-    if (src->length > available) {
-        if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
-            return SSTR_ERROR_OVERFLOW;
-        }
-        size_t copy_len = available;
-        memcpy(dest->data + dest->length, src->data, copy_len);
-        dest->length += copy_len;
-        dest->data[dest->length] = '\0';
-    } else {
-        memcpy(dest->data + dest->length, src->data, src->length);
-        dest->length += src->length;
-        dest->data[dest->length] = '\0';
-    }
+/* Toggles the case bit of the bytes in [first, first + 25] */
+static inline sstr_block sstr_block_case_flip(sstr_block v, unsigned char first)
+{
+    __m256i offset = _mm256_sub_epi8(v, _mm256_set1_epi8((char)first));
+    __m256i in_range = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(25)), offset);
+    return _mm256_xor_si256(v, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+}
 
-    return SSTR_SUCCESS;
+/* Flags the bytes sstr_json_special accepts */
+static inline sstr_block sstr_block_json(sstr_block v)
+{
+    __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v);
+    __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+    __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    return _mm256_or_si256(control, _mm256_or_si256(quote, backslash));
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SSTR_SCAN_BLOCK 16
+typedef __m128i sstr_block;
+
+static inline SSTR_NO_SANITIZE_ADDRESS sstr_block sstr_block_load(const unsigned char *p)
+{
+    return _mm_load_si128((const __m128i *)(const void *)p);
+}
+
+static inline void sstr_block_store(unsigned char *q, sstr_block v)
+{
+    _mm_storeu_si128((__m128i *)(void *)q, v);
+}
+
+static inline sstr_block sstr_block_nul(sstr_block v)
+{
+    return _mm_cmpeq_epi8(v, _mm_setzero_si128());
+}
+
+static inline sstr_block sstr_block_or(sstr_block a, sstr_block b)
+{
+    return _mm_or_si128(a, b);
+}
+
+static inline int sstr_block_any(sstr_block flags)
+{
+    return _mm_movemask_epi8(flags) != 0;
+}
+
+static inline sstr_block sstr_block_loadu(const unsigned char *p)
+{
+    return _mm_loadu_si128((const __m128i *)(const void *)p);
+}
+
+static inline sstr_block sstr_block_splat(unsigned char c)
+{
+    return _mm_set1_epi8((char)c);
+}
+
+static inline sstr_block sstr_block_eq(sstr_block v, sstr_block pattern)
+{
+    return _mm_cmpeq_epi8(v, pattern);
+}
+
+static inline sstr_block sstr_block_and(sstr_block a, sstr_block b)
+{
+    return _mm_and_si128(a, b);
+}
+
+static inline sstr_block sstr_block_case_flip(sstr_block v, unsigned char first)
+{
+    __m128i offset = _mm_sub_epi8(v, _mm_set1_epi8((char)first));
+    __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(25)), offset);
+    return _mm_xor_si128(v, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+}
+
+static inline sstr_block sstr_block_json(sstr_block v)
+{
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return _mm_or_si128(control, _mm_or_si128(quote, backslash));
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SSTR_SCAN_BLOCK 16
+typedef uint8x16_t sstr_block;
+
+static inline SSTR_NO_SANITIZE_ADDRESS sstr_block sstr_block_load(const unsigned char *p)
+{
+    return vld1q_u8(p);
+}
+
+static inline void sstr_block_store(unsigned char *q, sstr_block v)
+{
+    vst1q_u8(q, v);
+}
+
+static inline sstr_block sstr_block_nul(sstr_block v)
+{
+    return vceqzq_u8(v);
+}
+
+static inline sstr_block sstr_block_or(sstr_block a, sstr_block b)
+{
+    return vorrq_u8(a, b);
+}
+
+static inline int sstr_block_any(sstr_block flags)
+{
+    return vmaxvq_u8(flags) != 0;
+}
+
+static inline sstr_block sstr_block_loadu(const unsigned char *p)
+{
+    return vld1q_u8(p);
+}
+
+static inline sstr_block sstr_block_splat(unsigned char c)
+{
+    return vdupq_n_u8(c);
+}
+
+static inline sstr_block sstr_block_eq(sstr_block v, sstr_block pattern)
+{
+    return vceqq_u8(v, pattern);
+}
+
+static inline sstr_block sstr_block_and(sstr_block a, sstr_block b)
+{
+    return vandq_u8(a, b);
+}
+
+static inline sstr_block sstr_block_case_flip(sstr_block v, unsigned char first)
+{
+    uint8x16_t in_range = vcleq_u8(vsubq_u8(v, vdupq_n_u8(first)), vdupq_n_u8(25));
+    return veorq_u8(v, vandq_u8(in_range, vdupq_n_u8(0x20)));
+}
+
+static inline sstr_block sstr_block_json(sstr_block v)
+{
+    uint8x16_t control = vcltq_u8(v, vdupq_n_u8(0x20));
+    uint8x16_t quote = vceqq_u8(v, vdupq_n_u8('"'));
+    uint8x16_t backslash = vceqq_u8(v, vdupq_n_u8('\\'));
+    return vorrq_u8(control, vorrq_u8(quote, backslash));
+}
+#else
+#define SSTR_SCAN_BLOCK 8
+typedef uint64_t sstr_block;
+
+static inline SSTR_NO_SANITIZE_ADDRESS sstr_block sstr_block_load(const unsigned char *p)
+{
+    sstr_block v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void sstr_block_store(unsigned char *q, sstr_block v)
+{
+    memcpy(q, &v, sizeof(v));
+}
+
+/* Sets the high bit of each zero byte; may also flag a 0x01 byte above a
+ * zero byte, which does not matter when only testing for any zero */
+static inline sstr_block sstr_block_nul(sstr_block v)
+{
+    return (v - UINT64_C(0x0101010101010101)) & ~v & UINT64_C(0x8080808080808080);
+}
+
+static inline sstr_block sstr_block_or(sstr_block a, sstr_block b)
+{
+    return a | b;
+}
+
+static inline int sstr_block_any(sstr_block flags)
+{
+    return flags != 0;
+}
+
+static inline sstr_block sstr_block_loadu(const unsigned char *p)
+{
+    return sstr_block_load(p);
+}
+
+static inline sstr_block sstr_block_splat(unsigned char c)
+{
+    return UINT64_C(0x0101010101010101) * c;
+}
+
+/* Flags bytes equal to the pattern, with the same false positives as
+ * sstr_block_nul; callers confirm candidates byte by byte */
+static inline sstr_block sstr_block_eq(sstr_block v, sstr_block pattern)
+{
+    return sstr_block_nul(v ^ pattern);
+}
+
+static inline sstr_block sstr_block_and(sstr_block a, sstr_block b)
+{
+    return a & b;
+}
+
+/* Exact for every byte: the low seven bits of each byte are offset so the
+ * high bit tells whether they reach first and first + 26, and bytes with
+ * the high bit already set are left alone. No sum carries into the next
+ * byte. */
+static inline sstr_block sstr_block_case_flip(sstr_block v, unsigned char first)
+{
+    sstr_block low = v & UINT64_C(0x7f7f7f7f7f7f7f7f);
+    sstr_block from_first = low + sstr_block_splat((unsigned char)(0x80 - first));
+    sstr_block past_last = low + sstr_block_splat((unsigned char)(0x80 - first - 26));
+    sstr_block in_range = ~v & (from_first ^ past_last) & UINT64_C(0x8080808080808080);
+    return v ^ (in_range >> 2);
+}
+
+/* Flags bytes below 0x20 the way sstr_block_nul flags zero bytes, plus
+ * quotes and backslashes through sstr_block_eq, so a flagged word always
+ * holds at least one byte sstr_json_special accepts */
+static inline sstr_block sstr_block_json(sstr_block v)
+{
+    sstr_block control = (v - sstr_block_splat(0x20)) & ~v & UINT64_C(0x8080808080808080);
+    sstr_block quote = sstr_block_eq(v, sstr_block_splat('"'));
+    sstr_block backslash = sstr_block_eq(v, sstr_block_splat('\\'));
+    return control | quote | backslash;
+}
+#endif
+
+/* Blocks handled per iteration of the main loops. A stride is only taken
+ * from an address aligned to it, so like a single block it never spans a
+ * page. */
+#define SSTR_SCAN_STRIDE (4 * SSTR_SCAN_BLOCK)
+
+static inline int sstr_stride_aligned(const unsigned char *p)
+{
+    return ((uintptr_t)p & (SSTR_SCAN_STRIDE - 1)) == 0;
+}
+
+/* Returns the index of the first zero byte in str, or max_len if there is
+ * none within max_len bytes */
+static SSTR_NO_SANITIZE_ADDRESS size_t sstr_scan_nul(const char *str, size_t max_len)
+{
+    const unsigned char *p = (const unsigned char *)str;
+    size_t i = 0;
+
+    /* Bytes up to the first block boundary */
+    while (i < max_len && ((uintptr_t)(p + i) & (SSTR_SCAN_BLOCK - 1)) != 0) {
+        if (p[i] == '\0') {
+            return i;
+        }
+        i++;
+    }
+
+    /* Blocks that end within max_len, four at a time from a stride boundary */
+    while (max_len - i >= SSTR_SCAN_BLOCK) {
+        if (max_len - i >= SSTR_SCAN_STRIDE && sstr_stride_aligned(p + i)) {
+            sstr_block flags = sstr_block_or(
+                sstr_block_or(sstr_block_nul(sstr_block_load(p + i)),
+                              sstr_block_nul(sstr_block_load(p + i + SSTR_SCAN_BLOCK))),
+                sstr_block_or(sstr_block_nul(sstr_block_load(p + i + 2 * SSTR_SCAN_BLOCK)),
+                              sstr_block_nul(sstr_block_load(p + i + 3 * SSTR_SCAN_BLOCK))));
+            if (sstr_block_any(flags)) {
+                break;
+            }
+            i += SSTR_SCAN_STRIDE;
+            continue;
+        }
+        if (sstr_block_any(sstr_block_nul(sstr_block_load(p + i)))) {
+            break;
+        }
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    /* Locate the terminator within the block, or scan the tail */
+    while (i < max_len) {
+        if (p[i] == '\0') {
+            return i;
+        }
+        i++;
+    }
+
+    return max_len;
+}
+
+/* Copy src to dst up to its terminator in a single pass, writing at most
+ * max_len bytes and reading at most max_len + 1. Returns the length of src,
+ * or max_len + 1 if it is longer than max_len; the terminator is not written */
+static SSTR_NO_SANITIZE_ADDRESS size_t sstr_copy_nul(char *dst, const char *src, size_t max_len)
+{
+    const unsigned char *p = (const unsigned char *)src;
+    unsigned char *q = (unsigned char *)dst;
+    size_t i = 0;
+
+    /* Bytes up to the first block boundary of the source */
+    while (i < max_len && ((uintptr_t)(p + i) & (SSTR_SCAN_BLOCK - 1)) != 0) {
+        if (p[i] == '\0') {
+            return i;
+        }
+        q[i] = p[i];
+        i++;
+    }
+
+    /* Single blocks, or four at a time from a stride boundary, stored only
+     * once none holds the terminator */
+    while (max_len - i >= SSTR_SCAN_BLOCK) {
+        if (max_len - i >= SSTR_SCAN_STRIDE && sstr_stride_aligned(p + i)) {
+            sstr_block a = sstr_block_load(p + i);
+            sstr_block b = sstr_block_load(p + i + SSTR_SCAN_BLOCK);
+            sstr_block c = sstr_block_load(p + i + 2 * SSTR_SCAN_BLOCK);
+            sstr_block d = sstr_block_load(p + i + 3 * SSTR_SCAN_BLOCK);
+            sstr_block flags = sstr_block_or(sstr_block_or(sstr_block_nul(a), sstr_block_nul(b)),
+                                             sstr_block_or(sstr_block_nul(c), sstr_block_nul(d)));
+            if (sstr_block_any(flags)) {
+                break;
+            }
+            sstr_block_store(q + i, a);
+            sstr_block_store(q + i + SSTR_SCAN_BLOCK, b);
+            sstr_block_store(q + i + 2 * SSTR_SCAN_BLOCK, c);
+            sstr_block_store(q + i + 3 * SSTR_SCAN_BLOCK, d);
+            i += SSTR_SCAN_STRIDE;
+            continue;
+        }
+        sstr_block a = sstr_block_load(p + i);
+        if (sstr_block_any(sstr_block_nul(a))) {
+            break;
+        }
+        sstr_block_store(q + i, a);
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    /* Finish the block holding the terminator, or the tail */
+    while (i < max_len) {
+        if (p[i] == '\0') {
+            return i;
+        }
+        q[i] = p[i];
+        i++;
+    }
+
+    return p[max_len] == '\0' ? max_len : max_len + 1;
+}
+
+/* Returns the index of the first byte equal to c in data[0, len), or len.
+ * Unlike the terminator scans, every block read lies within data. */
+static size_t sstr_scan_byte(const char *data, size_t len, unsigned char c)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    sstr_block pattern = sstr_block_splat(c);
+    size_t i = 0;
+
+    while (i < len && ((uintptr_t)(p + i) & (SSTR_SCAN_BLOCK - 1)) != 0) {
+        if (p[i] == c) {
+            return i;
+        }
+        i++;
+    }
+
+    while (len - i >= SSTR_SCAN_STRIDE) {
+        sstr_block flags = sstr_block_or(
+            sstr_block_or(sstr_block_eq(sstr_block_load(p + i), pattern),
+                          sstr_block_eq(sstr_block_load(p + i + SSTR_SCAN_BLOCK), pattern)),
+            sstr_block_or(sstr_block_eq(sstr_block_load(p + i + 2 * SSTR_SCAN_BLOCK), pattern),
+                          sstr_block_eq(sstr_block_load(p + i + 3 * SSTR_SCAN_BLOCK), pattern)));
+        if (sstr_block_any(flags)) {
+            break;
+        }
+        i += SSTR_SCAN_STRIDE;
+    }
+    while (len - i >= SSTR_SCAN_BLOCK) {
+        if (sstr_block_any(sstr_block_eq(sstr_block_load(p + i), pattern))) {
+            break;
+        }
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    while (i < len) {
+        if (p[i] == c) {
+            return i;
+        }
+        i++;
+    }
+
+    return len;
+}
+
+/* Returns the index of the last byte equal to c in data[0, len), or len */
+static size_t sstr_scan_byte_rev(const char *data, size_t len, unsigned char c)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    sstr_block pattern = sstr_block_splat(c);
+    size_t i = len;
+
+    while (i > 0 && ((uintptr_t)(p + i) & (SSTR_SCAN_BLOCK - 1)) != 0) {
+        i--;
+        if (p[i] == c) {
+            return i;
+        }
+    }
+
+    while (i >= SSTR_SCAN_STRIDE) {
+        const unsigned char *q = p + i - SSTR_SCAN_STRIDE;
+        sstr_block flags = sstr_block_or(
+            sstr_block_or(sstr_block_eq(sstr_block_load(q), pattern),
+                          sstr_block_eq(sstr_block_load(q + SSTR_SCAN_BLOCK), pattern)),
+            sstr_block_or(sstr_block_eq(sstr_block_load(q + 2 * SSTR_SCAN_BLOCK), pattern),
+                          sstr_block_eq(sstr_block_load(q + 3 * SSTR_SCAN_BLOCK), pattern)));
+        if (sstr_block_any(flags)) {
+            break;
+        }
+        i -= SSTR_SCAN_STRIDE;
+    }
+    while (i >= SSTR_SCAN_BLOCK) {
+        if (sstr_block_any(sstr_block_eq(sstr_block_load(p + i - SSTR_SCAN_BLOCK), pattern))) {
+            break;
+        }
+        i -= SSTR_SCAN_BLOCK;
+    }
+
+    while (i > 0) {
+        i--;
+        if (p[i] == c) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+/* Returns the first index at which needle (1 <= n <= len) occurs in
+ * data[0, len), or len. Candidates must match both the first and the last
+ * byte of the needle, tested a block of positions at a time, before the
+ * bytes between are compared. */
+static size_t sstr_search(const char *data, size_t len, const char *needle, size_t n)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *w = (const unsigned char *)needle;
+    size_t last = len - n; /* Last possible start */
+
+    if (n == 1) {
+        return sstr_scan_byte(data, len, w[0]);
+    }
+
+    sstr_block first_pattern = sstr_block_splat(w[0]);
+    sstr_block last_pattern = sstr_block_splat(w[n - 1]);
+    size_t starts = last + 1;
+    size_t i = 0;
+
+    /* Skip four blocks of candidates at a time while all of them are
+     * possible starts, then resolve one block at a time */
+    for (;;) {
+        while (starts - i >= SSTR_SCAN_STRIDE) {
+            const unsigned char *q = p + i;
+            const unsigned char *r = p + i + n - 1;
+            sstr_block flags = sstr_block_or(
+                sstr_block_or(
+                    sstr_block_and(sstr_block_eq(sstr_block_loadu(q), first_pattern),
+                                   sstr_block_eq(sstr_block_loadu(r), last_pattern)),
+                    sstr_block_and(
+                        sstr_block_eq(sstr_block_loadu(q + SSTR_SCAN_BLOCK), first_pattern),
+                        sstr_block_eq(sstr_block_loadu(r + SSTR_SCAN_BLOCK), last_pattern))),
+                sstr_block_or(
+                    sstr_block_and(
+                        sstr_block_eq(sstr_block_loadu(q + 2 * SSTR_SCAN_BLOCK), first_pattern),
+                        sstr_block_eq(sstr_block_loadu(r + 2 * SSTR_SCAN_BLOCK), last_pattern)),
+                    sstr_block_and(
+                        sstr_block_eq(sstr_block_loadu(q + 3 * SSTR_SCAN_BLOCK), first_pattern),
+                        sstr_block_eq(sstr_block_loadu(r + 3 * SSTR_SCAN_BLOCK),
+                                      last_pattern))));
+            if (sstr_block_any(flags)) {
+                break;
+            }
+            i += SSTR_SCAN_STRIDE;
+        }
+
+        if (starts - i < SSTR_SCAN_BLOCK) {
+            break;
+        }
+
+        sstr_block flags =
+            sstr_block_and(sstr_block_eq(sstr_block_loadu(p + i), first_pattern),
+                           sstr_block_eq(sstr_block_loadu(p + i + n - 1), last_pattern));
+        if (sstr_block_any(flags)) {
+            for (size_t j = i; j < i + SSTR_SCAN_BLOCK; j++) {
+                if (p[j] == w[0] && p[j + n - 1] == w[n - 1] &&
+                    memcmp(p + j + 1, w + 1, n - 2) == 0) {
+                    return j;
+                }
+            }
+        }
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    for (; i <= last; i++) {
+        if (p[i] == w[0] && p[i + n - 1] == w[n - 1] && memcmp(p + i + 1, w + 1, n - 2) == 0) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+/* Flags the bytes of v equal to any of four patterns */
+static inline sstr_block sstr_block_eq4(sstr_block v, const sstr_block *patterns)
+{
+    sstr_block low = sstr_block_or(sstr_block_eq(v, patterns[0]), sstr_block_eq(v, patterns[1]));
+    sstr_block high = sstr_block_or(sstr_block_eq(v, patterns[2]), sstr_block_eq(v, patterns[3]));
+    return sstr_block_or(low, high);
+}
+
+/* Returns the index of the first byte of data[0, len) in a delimiter set,
+ * or len. The set holds count (1 to SSTR_SPLIT_SET_MAX) bytes, and map has
+ * exactly those bits set. Blocks are compared against four slots at a
+ * time, the unused ones repeating the first byte. */
+static size_t sstr_scan_set(const char *data, size_t len, const unsigned char *set, size_t count,
+                            const unsigned char *map)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    sstr_block patterns[SSTR_SPLIT_SET_MAX];
+    size_t i = 0;
+
+    if (count == 1) {
+        return sstr_scan_byte(data, len, set[0]);
+    }
+
+    while (i < len && ((uintptr_t)(p + i) & (SSTR_SCAN_BLOCK - 1)) != 0) {
+        if (sstr_map_has(map, p[i])) {
+            return i;
+        }
+        i++;
+    }
+
+    if (len - i >= SSTR_SCAN_BLOCK) {
+        for (size_t k = 0; k < SSTR_SPLIT_SET_MAX; k++) {
+            patterns[k] = sstr_block_splat(set[k < count ? k : 0]);
+        }
+    }
+
+    while (len - i >= SSTR_SCAN_BLOCK) {
+        sstr_block v = sstr_block_load(p + i);
+        sstr_block flags = sstr_block_eq4(v, patterns);
+        if (count > 4) {
+            flags = sstr_block_or(flags, sstr_block_eq4(v, patterns + 4));
+        }
+        if (sstr_block_any(flags)) {
+            break;
+        }
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    while (i < len) {
+        if (sstr_map_has(map, p[i])) {
+            return i;
+        }
+        i++;
+    }
+
+    return len;
+}
+
+/* Toggles the case of the ASCII letters of data[0, len) starting at first,
+ * 'A' for upper to lower and 'a' for lower to upper. Blocks are loaded and
+ * stored unaligned, so every access lies within data. */
+static void sstr_ascii_case(char *data, size_t len, unsigned char first)
+{
+    unsigned char *p = (unsigned char *)data;
+    size_t i = 0;
+
+    while (len - i >= SSTR_SCAN_BLOCK) {
+        sstr_block_store(p + i, sstr_block_case_flip(sstr_block_loadu(p + i), first));
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    for (; i < len; i++) {
+        p[i] = sstr_ascii_case_flip(p[i], first);
+    }
+}
+
+/* Returns the index of the first byte of data[0, len) that JSON needs
+ * escaped, or len. Blocks are loaded unaligned, so every access lies
+ * within data. */
+static size_t sstr_scan_json(const char *data, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    size_t i = 0;
+
+    while (len - i >= SSTR_SCAN_STRIDE) {
+        sstr_block flags = sstr_block_or(
+            sstr_block_or(sstr_block_json(sstr_block_loadu(p + i)),
+                          sstr_block_json(sstr_block_loadu(p + i + SSTR_SCAN_BLOCK))),
+            sstr_block_or(sstr_block_json(sstr_block_loadu(p + i + 2 * SSTR_SCAN_BLOCK)),
+                          sstr_block_json(sstr_block_loadu(p + i + 3 * SSTR_SCAN_BLOCK))));
+        if (sstr_block_any(flags)) {
+            break;
+        }
+        i += SSTR_SCAN_STRIDE;
+    }
+
+    while (len - i >= SSTR_SCAN_BLOCK) {
+        if (sstr_block_any(sstr_block_json(sstr_block_loadu(p + i)))) {
+            break;
+        }
+        i += SSTR_SCAN_BLOCK;
+    }
+
+    /* Past the last whole block, a clean final block overlapping it ends
+     * the run */
+    if (i < len && len - i < SSTR_SCAN_BLOCK && len >= SSTR_SCAN_BLOCK &&
+        !sstr_block_any(sstr_block_json(sstr_block_loadu(p + len - SSTR_SCAN_BLOCK)))) {
+        return len;
+    }
+
+    while (i < len && !sstr_json_special(p[i])) {
+        i++;
+    }
+
+    return i;
+}
+
+#endif /* SSTR_SCAN_WORDS */
+
+/* Get the length of a string with an explicit maximum to check
+ * Returns SSTR_SUCCESS if a null terminator is found within max_len
+ * Sets out_len to the length (not including null terminator)
+ * Returns SSTR_ERROR_OVERFLOW if no null terminator is found within max_len
+ *
+ * The byte loop is the reference implementation verified by CBMC and KLEE;
+ * other builds use the word-at-a-time scan when SSTR_ENABLE_SIMD is set
+ */
+static SStrResult sstr_bounded_strlen(const char *str, size_t max_len, size_t *out_len)
+{
+    if (str == NULL || out_len == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#if SSTR_SCAN_WORDS
+    size_t len = sstr_scan_nul(str, max_len);
+    if (len == max_len) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    *out_len = len;
+    return SSTR_SUCCESS;
+#else
+    /* For CBMC verification, limit the maximum length to check
+     * This allows CBMC to finish verification in reasonable time */
+#ifdef __CPROVER
+    /* When running under CBMC verification, assume small buffer sizes */
+    __CPROVER_assume(max_len <= 10);
+
+    /* Important: Make sure the string pointer is valid for reading */
+    __CPROVER_assume(__CPROVER_r_ok(str, max_len));
+#endif
+
+    /* Safety check for any null pointer dereference */
+    __CPROVER_assert(str != NULL, "String pointer is not null");
+
+    /* Use a bounded for loop with explicit limit for CBMC */
+    for (size_t i = 0; i < max_len; i++) {
+        /* For each index, ensure we can safely read this memory location */
+#ifdef __CPROVER
+        __CPROVER_assert(__CPROVER_r_ok(str + i, 1), "String access is safe");
+#endif
+
+        if (str[i] == '\0') {
+            *out_len = i;
+            return SSTR_SUCCESS;
+        }
+    }
+
+    /* No null terminator found within bounds */
+    return SSTR_ERROR_OVERFLOW;
+#endif
+}
+
+#if !SSTR_SCAN_WORDS
+/* Reference version of the fused copy: copy src to dst up to its
+ * terminator, at most max_len bytes, and return its length or max_len + 1 */
+static size_t sstr_copy_nul(char *dst, const char *src, size_t max_len)
+{
+    for (size_t i = 0; i < max_len; i++) {
+        if (src[i] == '\0') {
+            return i;
+        }
+        dst[i] = src[i];
+    }
+
+    return src[max_len] == '\0' ? max_len : max_len + 1;
+}
+#endif
+
+#if !SSTR_SCAN_WORDS
+/* Reference versions of the byte and substring searches, with the same
+ * contracts as the word-at-a-time kernels */
+static size_t sstr_scan_byte(const char *data, size_t len, unsigned char c)
+{
+    for (size_t i = 0; i < len; i++) {
+        if ((unsigned char)data[i] == c) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+static size_t sstr_scan_byte_rev(const char *data, size_t len, unsigned char c)
+{
+    for (size_t i = len; i > 0; i--) {
+        if ((unsigned char)data[i - 1] == c) {
+            return i - 1;
+        }
+    }
+
+    return len;
+}
+
+static size_t sstr_search(const char *data, size_t len, const char *needle, size_t n)
+{
+    for (size_t i = 0; i + n <= len; i++) {
+        if (data[i] == needle[0] && memcmp(data + i, needle, n) == 0) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+static void sstr_ascii_case(char *data, size_t len, unsigned char first)
+{
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (char)sstr_ascii_case_flip((unsigned char)data[i], first);
+    }
+}
+
+static size_t sstr_scan_set(const char *data, size_t len, const unsigned char *set, size_t count,
+                            const unsigned char *map)
+{
+    (void)set;
+    (void)count;
+
+    for (size_t i = 0; i < len; i++) {
+        if (sstr_map_has(map, (unsigned char)data[i])) {
+            return i;
+        }
+    }
+
+    return len;
+}
+
+static size_t sstr_scan_json(const char *data, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && !sstr_json_special((unsigned char)data[i])) {
+        i++;
+    }
+
+    return i;
+}
+#endif
+
+/* Whether str points into dest's buffer, terminator slot included */
+static inline int sstr_in_buffer(const SStr *dest, const char *str)
+{
+    return (size_t)((uintptr_t)str - (uintptr_t)dest->data) <= dest->capacity;
+}
+
+#if SSTR_ENABLE_GROWABLE
+/* Overflow path of the appends for growable strings: grow dest and append
+ * src_len characters of src. src may point into dest's own buffer, which
+ * moves when it is reallocated. */
+static SStrResult sstr_append_grow(SStr *dest, const char *src, size_t src_len)
+{
+    if (src_len > SSTR_CAPACITY_MAX - dest->length) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    size_t offset = (size_t)((uintptr_t)src - (uintptr_t)dest->data);
+    int inside = offset <= dest->capacity;
+
+    SStrResult result = sstr_reserve(dest, dest->length + src_len);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    if (inside) {
+        src = dest->data + offset;
+    }
+
+    memmove(dest->data + dest->length, src, src_len);
+    dest->length += src_len;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, src_len);
+
+    return SSTR_SUCCESS;
+}
+
+/* As sstr_append_grow for a C string whose length is not yet known */
+static SStrResult sstr_append_grow_cstr(SStr *dest, const char *src)
+{
+    size_t src_len;
+    if (sstr_bounded_strlen(src, SSTR_CAPACITY_MAX - dest->length + 1, &src_len) !=
+        SSTR_SUCCESS) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    return sstr_append_grow(dest, src, src_len);
+}
+#endif
+
+static inline SStrResult sstr_copy_impl(SStr *dest, const char *src, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (src == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#ifdef __CPROVER
+    /* For CBMC verification, use fixed small values to allow tractable verification */
+    __CPROVER_assume(dest->capacity <= 10);
+
+    /* Use CBMC's built-in primitives for memory safety checks */
+    /* Ensure the src pointer can be read for up to 'capacity+1' bytes */
+    __CPROVER_assume(__CPROVER_r_ok(src, dest->capacity + 1));
+
+    /* Ensure the dest->data pointer can be written for up to 'capacity+1' bytes */
+    __CPROVER_assume(__CPROVER_w_ok(dest->data, dest->capacity + 1));
+#endif
+
+    /* Ensure capacity is reasonable before proceeding: capacity + 1 must be
+     * representable in the length type */
+    __CPROVER_assert(dest->capacity < SSTR_LENGTH_MAX, "Destination capacity is reasonable");
+
+#if SSTR_SCAN_WORDS
+    size_t src_len;
+    if (policy == SSTR_ERROR) {
+        /* Bytes past the current content can be written before an overflow is
+         * known without losing anything; scan the rest first */
+        size_t keep = dest->length;
+        if (sstr_bounded_strlen(src, keep + 1, &src_len) == SSTR_SUCCESS) {
+            memcpy(dest->data, src, src_len);
+        } else {
+            size_t rest = sstr_copy_nul(dest->data + keep, src + keep, dest->capacity - keep);
+            if (rest > dest->capacity - keep) {
+                dest->data[keep] = '\0';
+                SSTR_STAT(COPY, OVERFLOW, dest, 0);
+                return SSTR_ERROR_OVERFLOW;
+            }
+            memcpy(dest->data, src, keep);
+            src_len = keep + rest;
+        }
+    } else {
+        src_len = sstr_copy_nul(dest->data, src, dest->capacity);
+        if (src_len > dest->capacity) {
+            SSTR_STAT(COPY, TRUNCATION, dest, 0);
+            src_len = dest->capacity;
+        }
+    }
+#else
+    /* Use a bounded check for string length */
+    size_t src_len;
+    SStrResult result = sstr_bounded_strlen(src, dest->capacity + 1, &src_len);
+
+    /* If source has no null terminator within maximum bounds, handle according to policy */
+    if (result == SSTR_ERROR_OVERFLOW) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(COPY, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(COPY, TRUNCATION, dest, 0);
+        src_len = dest->capacity;
+    }
+
+    /* Check if source fits in destination */
+    if (src_len > dest->capacity) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(COPY, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(COPY, TRUNCATION, dest, 0);
+        src_len = dest->capacity;
+    }
+
+    /* Double-check bounds before memory operations */
+    __CPROVER_assert(src_len <= dest->capacity, "Source length is within destination capacity");
+
+    /* Use a loop for CBMC verification instead of memcpy
+     * This gives CBMC explicit bounds to verify */
+#ifdef __CPROVER
+    for (size_t i = 0; i < src_len; i++) {
+        /* Verify each memory access is safe */
+        __CPROVER_assert(__CPROVER_r_ok(src + i, 1), "Source read is safe");
+        __CPROVER_assert(__CPROVER_w_ok(dest->data + i, 1), "Destination write is safe");
+
+        dest->data[i] = src[i];
+    }
+#else
+    memcpy(dest->data, src, src_len);
+#endif
+#endif
+
+    /* Ensure null termination */
+    dest->data[src_len] = '\0';
+    dest->length = src_len;
+    SSTR_STAT(COPY, WRITE, dest, src_len);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_copy(SStr *dest, const char *src)
+{
+    return sstr_copy_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_copy_ex(SStr *dest, const char *src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_copy_impl(dest, src, policy);
+}
+
+static inline SStrResult sstr_copy_n_impl(SStr *dest, const char *src, size_t src_len,
+                                          SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || src == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (src_len > dest->capacity) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(COPY, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        size_t copy_len = dest->capacity;
+        memcpy(dest->data, src, copy_len);
+        dest->data[copy_len] = '\0';
+        dest->length = copy_len;
+        SSTR_STAT(COPY, TRUNCATION, dest, 0);
+    } else {
+        memcpy(dest->data, src, src_len);
+        dest->data[src_len] = '\0';
+        dest->length = src_len;
+    }
+    SSTR_STAT(COPY, WRITE, dest, dest->length);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult(sstr_copy_n)(SStr *dest, const char *src, size_t src_len)
+{
+    return sstr_copy_n_impl(dest, src, src_len, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_copy_n_ex(SStr *dest, const char *src, size_t src_len, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_copy_n_impl(dest, src, src_len, policy);
+}
+
+static inline SStrResult sstr_append_impl(SStr *dest, const char *src, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (src == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#ifdef __CPROVER
+    /* For CBMC verification, limit capacity and length to avoid state explosion */
+    __CPROVER_assume(dest->capacity <= 10);
+    __CPROVER_assume(dest->length <= dest->capacity);
+
+    /* Calculate available space only after constraining length/capacity */
+    size_t available = dest->capacity - dest->length;
+
+    /* Use CBMC's built-in primitives for memory safety checks */
+    /* Ensure the src pointer can be read for up to 'available+1' bytes */
+    __CPROVER_assume(__CPROVER_r_ok(src, available + 1));
+
+    /* Ensure the dest->data pointer can be written for the appropriate range */
+    __CPROVER_assume(__CPROVER_w_ok(dest->data + dest->length, available + 1));
+#endif
+
+    /* Verify length is within capacity */
+    __CPROVER_assert(dest->length <= dest->capacity, "Destination length is within capacity");
+
+    size_t available = dest->capacity - dest->length;
+
+#if SSTR_SCAN_WORDS
+    /* Copy and find the terminator in one pass; the copied bytes lie past
+     * the content, so an overflow only has to restore the terminator. A
+     * source in dest's own buffer would have its terminator overwritten by
+     * the copy, so it is measured first and moved afterwards. */
+    int inside = sstr_in_buffer(dest, src);
+    size_t src_len;
+    if (inside) {
+        if (sstr_bounded_strlen(src, available + 1, &src_len) != SSTR_SUCCESS) {
+            src_len = available + 1;
+        }
+    } else {
+        src_len = sstr_copy_nul(dest->data + dest->length, src, available);
+    }
+    if (src_len > available) {
+#if SSTR_ENABLE_GROWABLE
+        if (dest->allocator != NULL && sstr_append_grow_cstr(dest, src) == SSTR_SUCCESS) {
+            return SSTR_SUCCESS;
+        }
+#endif
+        if (policy == SSTR_ERROR) {
+            dest->data[dest->length] = '\0';
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        src_len = available;
+    }
+    if (inside) {
+        memmove(dest->data + dest->length, src, src_len);
+    }
+#else
+    /* Use a bounded check for string length */
+    size_t src_len;
+    SStrResult result = sstr_bounded_strlen(src, available + 1, &src_len);
+
+#if SSTR_ENABLE_GROWABLE
+    if (dest->allocator != NULL && (result == SSTR_ERROR_OVERFLOW || src_len > available) &&
+        sstr_append_grow_cstr(dest, src) == SSTR_SUCCESS) {
+        return SSTR_SUCCESS;
+    }
+#endif
+
+    /* If source has no null terminator within bounds, handle according to policy */
+    if (result == SSTR_ERROR_OVERFLOW) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        src_len = available;
+    }
+
+    /* Check if source fits in destination's available space */
+    if (src_len > available) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        src_len = available;
+    }
+
+    /* CBMC assertion: source length is within available space */
+    __CPROVER_assert(src_len <= available, "Source length is within available capacity");
+
+    /* Use a loop for CBMC verification instead of memcpy
+     * This gives CBMC explicit bounds to verify */
+#ifdef __CPROVER
+    for (size_t i = 0; i < src_len; i++) {
+        /* Verify each memory access is safe */
+        __CPROVER_assert(__CPROVER_r_ok(src + i, 1), "Source read is safe");
+        __CPROVER_assert(__CPROVER_w_ok(dest->data + dest->length + i, 1),
+                         "Destination write is safe");
+
+        __CPROVER_assert(i < src_len, "Append index is within source length");
+        __CPROVER_assert(dest->length + i < dest->capacity,
+                         "Append index is within destination capacity");
+        dest->data[dest->length + i] = src[i];
+    }
+#else
+    memcpy(dest->data + dest->length, src, src_len);
+#endif
+#endif
+
+    dest->length += src_len;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, src_len);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_append(SStr *dest, const char *src)
+{
+    return sstr_append_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_ex(SStr *dest, const char *src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_impl(dest, src, policy);
+}
+
+static inline SStrResult sstr_append_sstr_impl(SStr *dest, const SStr *src,
+                                               SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || src == NULL || src->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t available = dest->capacity - dest->length;
+
+    if (src->length > available) {
+#if SSTR_ENABLE_GROWABLE
+        if (dest->allocator != NULL &&
+            sstr_append_grow(dest, src->data, src->length) == SSTR_SUCCESS) {
+            return SSTR_SUCCESS;
+        }
+#endif
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        size_t copy_len = available;
+        memcpy(dest->data + dest->length, src->data, copy_len);
+        dest->length += copy_len;
+        dest->data[dest->length] = '\0';
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        SSTR_STAT(APPEND, WRITE, dest, copy_len);
+    } else {
+        memcpy(dest->data + dest->length, src->data, src->length);
+        dest->length += src->length;
+        dest->data[dest->length] = '\0';
+        SSTR_STAT(APPEND, WRITE, dest, src->length);
+    }
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult(sstr_append_sstr)(SStr *dest, const SStr *src)
+{
+    return sstr_append_sstr_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_sstr_ex(SStr *dest, const SStr *src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_sstr_impl(dest, src, policy);
+}
+
+SStrResult sstr_to_lower(SStr *s)
+{
+    if (s == NULL || s->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    sstr_ascii_case(s->data, s->length, 'A');
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_to_upper(SStr *s)
+{
+    if (s == NULL || s->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    sstr_ascii_case(s->data, s->length, 'a');
+
+    return SSTR_SUCCESS;
+}
+
+/* Trimming stops at the first non-space byte from each end, which is
+ * usually within a few bytes, so these stay byte loops */
+SStrResult sstr_trim_right(SStr *s)
+{
+    if (s == NULL || s->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t len = s->length;
+    while (len > 0 && sstr_ascii_space((unsigned char)s->data[len - 1])) {
+        len--;
+    }
+
+    s->length = len;
+    s->data[len] = '\0';
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_trim_left(SStr *s)
+{
+    if (s == NULL || s->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t len = s->length;
+    size_t start = 0;
+    while (start < len && sstr_ascii_space((unsigned char)s->data[start])) {
+        start++;
+    }
+
+    if (start > 0) {
+        memmove(s->data, s->data + start, len - start);
+        s->length = len - start;
+        s->data[s->length] = '\0';
+    }
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_trim(SStr *s)
+{
+    /* Trim the end first so less is moved */
+    SStrResult result = sstr_trim_right(s);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    return sstr_trim_left(s);
+}
+
+/* Room check shared by the encoders, which know their exact output length
+ * up front. Grows dest if it can, pointing *src at its new address if it
+ * lies in dest's own buffer; otherwise SSTR_ERROR rejects output that does
+ * not fit, and SSTR_TRUNCATE sets *room to the space left, into which the
+ * encoder writes only whole escapes, digit pairs or groups. */
+static SStrResult sstr_encode_room(SStr *dest, size_t needed, SStrTruncationPolicy policy,
+                                   size_t *room, const void **src)
+{
+    size_t available = (size_t)dest->capacity - dest->length;
+
+    if (needed > available) {
+#if SSTR_ENABLE_GROWABLE
+        size_t offset = (size_t)((uintptr_t)*src - (uintptr_t)dest->data);
+        int inside = sstr_in_buffer(dest, (const char *)*src);
+
+        if (dest->allocator != NULL && needed <= SSTR_CAPACITY_MAX - dest->length &&
+            sstr_reserve(dest, dest->length + needed) == SSTR_SUCCESS) {
+            if (inside) {
+                *src = dest->data + offset;
+            }
+            *room = needed;
+            return SSTR_SUCCESS;
+        }
+#else
+        (void)src;
+#endif
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        *room = available;
+        return SSTR_SUCCESS;
+    }
+
+    *room = needed;
+    return SSTR_SUCCESS;
+}
+
+/* Short escapes for the control characters, 0 where \u00XX is needed */
+static const char sstr_json_short[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0,   0,   0,   0, 0,   0,   0, 0,
+};
+
+static const char sstr_encode_hex_lower[17] = "0123456789abcdef";
+static const char sstr_encode_hex_upper[17] = "0123456789ABCDEF";
+
+/* Writes the escape for a byte sstr_json_special accepts, returning its length */
+static size_t sstr_json_escape(unsigned char c, char *out)
+{
+    out[0] = '\\';
+
+    if (c == '"' || c == '\\') {
+        out[1] = (char)c;
+        return 2;
+    }
+
+    if (sstr_json_short[c] != 0) {
+        out[1] = sstr_json_short[c];
+        return 2;
+    }
+
+    memcpy(out + 1, "u00", 3);
+    out[4] = sstr_encode_hex_lower[c >> 4];
+    out[5] = sstr_encode_hex_lower[c & 0xF];
+    return 6;
+}
+
+static inline SStrResult sstr_append_json_escaped_impl(SStr *dest, SStrView src,
+                                                       SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || src.data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Measure: every special byte grows by the rest of its escape */
+    size_t first = sstr_scan_json(src.data, src.length);
+    size_t needed = src.length;
+    for (size_t i = first; i < src.length;) {
+        unsigned char c = (unsigned char)src.data[i];
+        needed += c == '"' || c == '\\' || sstr_json_short[c] != 0 ? 1 : 5;
+        i++;
+        i += sstr_scan_json(src.data + i, src.length - i);
+    }
+
+    size_t room;
+    const void *data = src.data;
+    SStrResult result = sstr_encode_room(dest, needed, policy, &room, &data);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+    src.data = (const char *)data;
+
+    char *out = dest->data + dest->length;
+    size_t i = 0;
+    size_t run = first;
+
+    for (;;) {
+        /* Copy the run that needs no escaping in one go */
+        if (run > room) {
+            run = room;
+        }
+        memcpy(out, src.data + i, run);
+        out += run;
+        room -= run;
+        i += run;
+
+        if (i == src.length || room == 0) {
+            break;
+        }
+
+        char escape[6];
+        size_t escape_len = sstr_json_escape((unsigned char)src.data[i], escape);
+        if (escape_len > room) {
+            break;
+        }
+        memcpy(out, escape, escape_len);
+        out += escape_len;
+        room -= escape_len;
+        i++;
+
+        run = sstr_scan_json(src.data + i, src.length - i);
+    }
+
+    size_t written = (size_t)(out - (dest->data + dest->length));
+    dest->length += written;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, written);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_append_json_escaped(SStr *dest, SStrView src)
+{
+    return sstr_append_json_escaped_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_json_escaped_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_json_escaped_impl(dest, src, policy);
+}
+
+static inline SStrResult sstr_append_hex_bytes_impl(SStr *dest, const void *data, size_t length,
+                                                    int uppercase, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Output too long for any SStr asks for one more than fits, leaving the
+     * policy to reject or truncate it */
+    size_t needed = length > SSTR_CAPACITY_MAX / 2 ? SSTR_CAPACITY_MAX + 1 : 2 * length;
+
+    size_t room;
+    SStrResult result = sstr_encode_room(dest, needed, policy, &room, &data);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    const unsigned char *p = (const unsigned char *)data;
+    const char *digits = uppercase ? sstr_encode_hex_upper : sstr_encode_hex_lower;
+    char *out = dest->data + dest->length;
+    size_t count = room / 2;
+
+    for (size_t i = 0; i < count; i++) {
+        unsigned char byte = p[i];
+        out[2 * i] = digits[byte >> 4];
+        out[2 * i + 1] = digits[byte & 0xF];
+    }
+
+    dest->length += 2 * count;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, 2 * count);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_append_hex_bytes(SStr *dest, const void *data, size_t length, int uppercase)
+{
+    return sstr_append_hex_bytes_impl(dest, data, length, uppercase, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_hex_bytes_ex(SStr *dest, const void *data, size_t length, int uppercase,
+                                    SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_hex_bytes_impl(dest, data, length, uppercase, policy);
+}
+
+static const char sstr_base64_alphabet[65] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static inline SStrResult sstr_append_base64_impl(SStr *dest, const void *data, size_t length,
+                                                 SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t groups = length / 3 + (length % 3 != 0);
+    size_t needed = groups > SSTR_CAPACITY_MAX / 4 ? SSTR_CAPACITY_MAX + 1 : 4 * groups;
+
+    size_t room;
+    SStrResult result = sstr_encode_room(dest, needed, policy, &room, &data);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    const unsigned char *p = (const unsigned char *)data;
+    char *out = dest->data + dest->length;
+    size_t count = room / 4;
+    size_t full = count < length / 3 ? count : length / 3;
+
+    for (size_t g = 0; g < full; g++) {
+        uint32_t bits = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+        out[0] = sstr_base64_alphabet[bits >> 18];
+        out[1] = sstr_base64_alphabet[(bits >> 12) & 0x3F];
+        out[2] = sstr_base64_alphabet[(bits >> 6) & 0x3F];
+        out[3] = sstr_base64_alphabet[bits & 0x3F];
+        p += 3;
+        out += 4;
+    }
+
+    /* One or two trailing bytes make a final group padded with '=' */
+    if (count > full) {
+        size_t rest = length - 3 * full;
+        uint32_t bits = ((uint32_t)p[0] << 16) | (rest > 1 ? (uint32_t)p[1] << 8 : 0);
+        out[0] = sstr_base64_alphabet[bits >> 18];
+        out[1] = sstr_base64_alphabet[(bits >> 12) & 0x3F];
+        out[2] = rest > 1 ? sstr_base64_alphabet[(bits >> 6) & 0x3F] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+
+    size_t written = (size_t)(out - (dest->data + dest->length));
+    dest->length += written;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, written);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_append_base64(SStr *dest, const void *data, size_t length)
+{
+    return sstr_append_base64_impl(dest, data, length, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_base64_ex(SStr *dest, const void *data, size_t length,
+                                 SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_base64_impl(dest, data, length, policy);
+}
+
+SStrView sstr_view_from_cstr(const char *src)
+{
+    SStrView view = {NULL, 0};
+    size_t src_len;
+
+    if (sstr_bounded_strlen(src, SSTR_MAX_SIZE + 1, &src_len) == SSTR_SUCCESS) {
+        view.data = src;
+        view.length = src_len;
+    }
+
+    return view;
+}
+
+SStrView sstr_view_from_sstr(const SStr *src)
+{
+    SStrView view = {NULL, 0};
+
+    if (src != NULL && src->data != NULL) {
+        view.data = src->data;
+        view.length = src->length;
+    }
+
+    return view;
+}
+
+static inline SStrResult sstr_copy_view_impl(SStr *dest, SStrView src, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || src.data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t copy_len = src.length;
+
+    if (copy_len > dest->capacity) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(COPY, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(COPY, TRUNCATION, dest, 0);
+        copy_len = dest->capacity;
+    }
+
+    /* The view may point into the destination itself */
+    memmove(dest->data, src.data, copy_len);
+    dest->data[copy_len] = '\0';
+    dest->length = copy_len;
+    SSTR_STAT(COPY, WRITE, dest, copy_len);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult(sstr_copy_view)(SStr *dest, SStrView src)
+{
+    return sstr_copy_view_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_copy_view_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_copy_view_impl(dest, src, policy);
+}
+
+static inline SStrResult sstr_append_view_impl(SStr *dest, SStrView src,
+                                               SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || src.data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t available = dest->capacity - dest->length;
+    size_t copy_len = src.length;
+
+    if (copy_len > available) {
+#if SSTR_ENABLE_GROWABLE
+        if (dest->allocator != NULL &&
+            sstr_append_grow(dest, src.data, src.length) == SSTR_SUCCESS) {
+            return SSTR_SUCCESS;
+        }
+#endif
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+        copy_len = available;
+    }
+
+    memmove(dest->data + dest->length, src.data, copy_len);
+    dest->length += copy_len;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, copy_len);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult(sstr_append_view)(SStr *dest, SStrView src)
+{
+    return sstr_append_view_impl(dest, src, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_view_ex(SStr *dest, SStrView src, SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_view_impl(dest, src, policy);
+}
+
+int sstr_view_compare(SStrView a, SStrView b)
+{
+    size_t common = a.length < b.length ? a.length : b.length;
+    int result = common > 0 ? memcmp(a.data, b.data, common) : 0;
+
+    if (result != 0) {
+        return result;
+    }
+    if (a.length == b.length) {
+        return 0;
+    }
+    return a.length < b.length ? -1 : 1;
+}
+
+int sstr_view_equals(SStrView a, SStrView b)
+{
+    return a.length == b.length && (a.length == 0 || memcmp(a.data, b.data, a.length) == 0);
+}
+
+static inline unsigned char sstr_ascii_lower(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+}
+
+int sstr_view_compare_icase(SStrView a, SStrView b)
+{
+    size_t common = a.length < b.length ? a.length : b.length;
+
+    for (size_t i = 0; i < common; i++) {
+        unsigned char x = (unsigned char)a.data[i];
+        unsigned char y = (unsigned char)b.data[i];
+        if (x != y) {
+            x = sstr_ascii_lower(x);
+            y = sstr_ascii_lower(y);
+            if (x != y) {
+                return x < y ? -1 : 1;
+            }
+        }
+    }
+
+    if (a.length == b.length) {
+        return 0;
+    }
+    return a.length < b.length ? -1 : 1;
+}
+
+int sstr_view_equals_icase(SStrView a, SStrView b)
+{
+    return a.length == b.length && sstr_view_compare_icase(a, b) == 0;
+}
+
+int sstr_compare(const SStr *a, const SStr *b)
+{
+    return sstr_view_compare(sstr_view_from_sstr(a), sstr_view_from_sstr(b));
+}
+
+int sstr_equals(const SStr *a, const SStr *b)
+{
+    return sstr_view_equals(sstr_view_from_sstr(a), sstr_view_from_sstr(b));
+}
+
+int sstr_compare_icase(const SStr *a, const SStr *b)
+{
+    return sstr_view_compare_icase(sstr_view_from_sstr(a), sstr_view_from_sstr(b));
+}
+
+int sstr_equals_icase(const SStr *a, const SStr *b)
+{
+    return sstr_view_equals_icase(sstr_view_from_sstr(a), sstr_view_from_sstr(b));
+}
+
+/* Hashing
+ *
+ * The structure follows wyhash: 64x64 -> 128-bit multiplies folded to 64
+ * bits, three independent lanes for long inputs, and overlapping loads
+ * for the final bytes so no read goes past v.length. Loads are assembled
+ * little-endian, which compilers turn into plain loads on such targets,
+ * to give the same hash on every platform.
+ */
+static const uint64_t sstr_hash_secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                             0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+static inline void sstr_mum(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 sstr_u128;
+    sstr_u128 r = (sstr_u128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t lo = t + (rm1 << 32);
+    uint64_t carry = (uint64_t)(t < rl) + (uint64_t)(lo < t);
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t sstr_mix(uint64_t a, uint64_t b)
+{
+    sstr_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t sstr_read64(const unsigned char *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+           (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 |
+           (uint64_t)p[7] << 56;
+}
+
+static inline uint64_t sstr_read32(const unsigned char *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+}
+
+uint64_t sstr_view_hash_seed(SStrView v, uint64_t seed)
+{
+    const unsigned char *p = (const unsigned char *)v.data;
+    size_t len = v.data != NULL ? v.length : 0;
+    const uint64_t *s = sstr_hash_secret;
+    uint64_t a, b;
+
+    seed ^= sstr_mix(seed ^ s[0], s[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t step = (len >> 3) << 2; /* 0 below 8 bytes, 4 from 8 */
+            a = (sstr_read32(p) << 32) | sstr_read32(p + step);
+            b = (sstr_read32(p + len - 4) << 32) | sstr_read32(p + len - 4 - step);
+        } else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = sstr_mix(sstr_read64(p) ^ s[1], sstr_read64(p + 8) ^ seed);
+                lane1 = sstr_mix(sstr_read64(p + 16) ^ s[2], sstr_read64(p + 24) ^ lane1);
+                lane2 = sstr_mix(sstr_read64(p + 32) ^ s[3], sstr_read64(p + 40) ^ lane2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (i > 16) {
+            seed = sstr_mix(sstr_read64(p) ^ s[1], sstr_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = sstr_read64(p + i - 16);
+        b = sstr_read64(p + i - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    sstr_mum(&a, &b);
+    return sstr_mix(a ^ s[0] ^ (uint64_t)len, b ^ s[1]);
+}
+
+uint64_t sstr_view_hash(SStrView v)
+{
+    return sstr_view_hash_seed(v, 0);
+}
+
+uint64_t sstr_hash(const SStr *s)
+{
+    return sstr_view_hash_seed(sstr_view_from_sstr(s), 0);
+}
+
+size_t sstr_view_find_char(SStrView v, char c)
+{
+    if (v.data == NULL) {
+        return SSTR_NPOS;
+    }
+
+    size_t i = sstr_scan_byte(v.data, v.length, (unsigned char)c);
+    return i == v.length ? SSTR_NPOS : i;
+}
+
+size_t sstr_view_rfind_char(SStrView v, char c)
+{
+    if (v.data == NULL) {
+        return SSTR_NPOS;
+    }
+
+    size_t i = sstr_scan_byte_rev(v.data, v.length, (unsigned char)c);
+    return i == v.length ? SSTR_NPOS : i;
+}
+
+size_t sstr_view_find(SStrView haystack, SStrView needle)
+{
+    if (haystack.data == NULL || needle.data == NULL || needle.length > haystack.length) {
+        return SSTR_NPOS;
+    }
+
+    if (needle.length == 0) {
+        return 0;
+    }
+
+    size_t i = sstr_search(haystack.data, haystack.length, needle.data, needle.length);
+    return i == haystack.length ? SSTR_NPOS : i;
+}
+
+size_t sstr_view_rfind(SStrView haystack, SStrView needle)
+{
+    if (haystack.data == NULL || needle.data == NULL || needle.length > haystack.length) {
+        return SSTR_NPOS;
+    }
+
+    if (needle.length == 0) {
+        return haystack.length;
+    }
+
+    /* Walk back over occurrences of the first byte among the possible starts */
+    size_t end = haystack.length - needle.length + 1;
+    while (end > 0) {
+        size_t i = sstr_scan_byte_rev(haystack.data, end, (unsigned char)needle.data[0]);
+        if (i == end) {
+            break;
+        }
+        if (memcmp(haystack.data + i, needle.data, needle.length) == 0) {
+            return i;
+        }
+        end = i;
+    }
+
+    return SSTR_NPOS;
+}
+
+size_t sstr_find_char(const SStr *s, char c)
+{
+    return sstr_view_find_char(sstr_view_from_sstr(s), c);
+}
+
+size_t sstr_rfind_char(const SStr *s, char c)
+{
+    return sstr_view_rfind_char(sstr_view_from_sstr(s), c);
+}
+
+size_t sstr_find(const SStr *s, SStrView needle)
+{
+    return sstr_view_find(sstr_view_from_sstr(s), needle);
+}
+
+size_t sstr_rfind(const SStr *s, SStrView needle)
+{
+    return sstr_view_rfind(sstr_view_from_sstr(s), needle);
+}
+
+SStrResult sstr_split_init(SStrSplitIter *it, SStrView src, char delim)
+{
+    SStrView delims = {&delim, 1};
+    return sstr_split_init_set(it, src, delims);
+}
+
+SStrResult sstr_split_init_set(SStrSplitIter *it, SStrView src, SStrView delims)
+{
+    if (it == NULL || src.data == NULL || (delims.length > 0 && delims.data == NULL)) {
+        return SSTR_ERROR_NULL;
+    }
+
+    it->data = src.data;
+    it->length = src.length;
+    it->pos = 0;
+    it->done = 0;
+    it->count = 0;
+    memset(it->map, 0, sizeof(it->map));
+
+    for (size_t i = 0; i < delims.length; i++) {
+        unsigned char c = (unsigned char)delims.data[i];
+        if (sstr_map_has(it->map, c)) {
+            continue;
+        }
+        it->map[c >> 3] |= (unsigned char)(1u << (c & 7));
+        if (it->count < SSTR_SPLIT_SET_MAX) {
+            it->set[it->count] = c;
+        }
+        it->count++;
+    }
+
+    return SSTR_SUCCESS;
+}
+
+int sstr_split_next(SStrSplitIter *it, SStrView *token)
+{
+    if (it == NULL || token == NULL || it->done) {
+        return 0;
+    }
+
+    const char *start = it->data + it->pos;
+    size_t remaining = it->length - it->pos;
+    size_t i;
+
+    if (it->count == 0) {
+        i = remaining;
+    } else if (it->count <= SSTR_SPLIT_SET_MAX) {
+        i = sstr_scan_set(start, remaining, it->set, it->count, it->map);
+    } else {
+        /* Too many delimiters to compare a block against: use the bitmap */
+        i = 0;
+        while (i < remaining && !sstr_map_has(it->map, (unsigned char)start[i])) {
+            i++;
+        }
+    }
+
+    token->data = start;
+    token->length = i;
+    if (i == remaining) {
+        it->done = 1;
+    } else {
+        it->pos += i + 1;
+    }
+
+    return 1;
+}
+
+static inline SStrResult sstr_append_many_impl(SStr *dest, const SStrView *parts, size_t count,
+                                               SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || (parts == NULL && count > 0)) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Validate every part and check capacity once for the whole batch */
+    size_t available = dest->capacity - dest->length;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (parts[i].data == NULL) {
+            return SSTR_ERROR_NULL;
+        }
+        if (parts[i].length > SSTR_MAX_SIZE - total) {
+            total = SSTR_MAX_SIZE;
+        } else {
+            total += parts[i].length;
+        }
+    }
+
+#if SSTR_ENABLE_GROWABLE
+    /* Parts may point into dest's own buffer, which moves if it grows */
+    uintptr_t old_data = (uintptr_t)dest->data;
+    size_t old_capacity = dest->capacity;
+
+    if (total > available && dest->allocator != NULL &&
+        total <= SSTR_CAPACITY_MAX - dest->length &&
+        sstr_reserve(dest, dest->length + total) == SSTR_SUCCESS) {
+        available = dest->capacity - dest->length;
+    }
+#endif
+
+    if (total > available) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+    }
+
+    char *end = dest->data + dest->length;
+    size_t remaining = available;
+    for (size_t i = 0; i < count && remaining > 0; i++) {
+        size_t part_len = parts[i].length < remaining ? parts[i].length : remaining;
+        const char *src = parts[i].data;
+#if SSTR_ENABLE_GROWABLE
+        if ((uintptr_t)src - old_data <= old_capacity) {
+            src = dest->data + ((uintptr_t)src - old_data);
+        }
+#endif
+        memmove(end, src, part_len);
+        end += part_len;
+        remaining -= part_len;
+    }
+
+    dest->length += available - remaining;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, available - remaining);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_append_many(SStr *dest, const SStrView *parts, size_t count)
+{
+    return sstr_append_many_impl(dest, parts, count, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_many_ex(SStr *dest, const SStrView *parts, size_t count,
+                               SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_append_many_impl(dest, parts, count, policy);
+}
+
+#if SSTR_ENABLE_GROWABLE
+/* Grow dest for sstr_concat so that part fits after the pending characters
+ * already copied past the content, pointing part at its new address if it
+ * lies in dest's own buffer */
+static SStrResult sstr_concat_grow(SStr *dest, const char **part, size_t pending)
+{
+    size_t room = SSTR_CAPACITY_MAX - dest->length - pending;
+    size_t part_len;
+    if (sstr_bounded_strlen(*part, room + 1, &part_len) != SSTR_SUCCESS || part_len > room) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    size_t offset = (size_t)((uintptr_t)*part - (uintptr_t)dest->data);
+    int inside = offset <= dest->capacity;
+
+    SStrResult result = sstr_reserve(dest, dest->length + pending + part_len);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    if (inside) {
+        *part = dest->data + offset;
+    }
+
+    return SSTR_SUCCESS;
+}
+#endif
+
+/* Copy one part of sstr_concat total bytes past dest's content as
+ * sstr_copy_nul does. A part in dest's own buffer is measured before it is
+ * moved, since the copy could overwrite its terminator; for the same reason
+ * the first byte past the content is held back in *first. */
+static size_t sstr_concat_part(SStr *dest, size_t total, const char *part, size_t room,
+                               char *first)
+{
+    char *tail = dest->data + dest->length;
+    size_t part_len;
+
+    if (sstr_in_buffer(dest, part)) {
+        if (sstr_bounded_strlen(part, room + 1, &part_len) != SSTR_SUCCESS) {
+            part_len = room + 1;
+        }
+        memmove(tail + total, part, part_len <= room ? part_len : room);
+    } else {
+        part_len = sstr_copy_nul(tail + total, part, room);
+    }
+
+    if (total == 0 && part_len > 0 && room > 0) {
+        *first = tail[0];
+        tail[0] = '\0';
+    }
+
+    return part_len;
+}
+
+static SStrResult sstr_vconcat(SStr *dest, SStrTruncationPolicy policy, va_list args)
+{
+    if (dest == NULL || dest->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Each part is copied and scanned in one pass into the space past the
+     * content, which an overflow can discard by restoring the terminator */
+    size_t available = dest->capacity - dest->length;
+    char *tail = dest->data + dest->length;
+    size_t total = 0;
+    char first = '\0';
+    SStrResult result = SSTR_SUCCESS;
+
+#if SSTR_ENABLE_GROWABLE
+    /* Parts may point into dest's own buffer, which moves if it grows */
+    uintptr_t old_data = (uintptr_t)dest->data;
+    size_t old_capacity = dest->capacity;
+#endif
+
+    const char *part;
+    while ((part = va_arg(args, const char *)) != NULL) {
+#if SSTR_ENABLE_GROWABLE
+        if ((uintptr_t)part - old_data <= old_capacity) {
+            part = dest->data + ((uintptr_t)part - old_data);
+        }
+#endif
+        size_t room = available - total;
+        size_t part_len = sstr_concat_part(dest, total, part, room, &first);
+
+#if SSTR_ENABLE_GROWABLE
+        /* Grow to hold the whole part and copy it again; the parts already
+         * copied past the content move along with the buffer */
+        if (part_len > room && dest->allocator != NULL &&
+            sstr_concat_grow(dest, &part, total) == SSTR_SUCCESS) {
+            available = dest->capacity - dest->length;
+            tail = dest->data + dest->length;
+            room = available - total;
+            part_len = sstr_concat_part(dest, total, part, room, &first);
+        }
+#endif
+
+        if (part_len > room) {
+            if (policy == SSTR_ERROR) {
+                result = SSTR_ERROR_OVERFLOW;
+            } else {
+                SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+            }
+            total = available;
+            break;
+        }
+        total += part_len;
+    }
+
+    if (result != SSTR_SUCCESS) {
+        tail[0] = '\0';
+        SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+        return result;
+    }
+
+    if (total > 0) {
+        tail[0] = first;
+    }
+    dest->length += total;
+    dest->data[dest->length] = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, total);
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_concat(SStr *dest, ...)
+{
+    va_list args;
+    va_start(args, dest);
+    SStrResult result = sstr_vconcat(dest, SSTR_DEFAULT_POLICY, args);
+    va_end(args);
+    return result;
+}
+
+SStrResult sstr_concat_ex(SStr *dest, SStrTruncationPolicy policy, ...)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    va_list args;
+    va_start(args, policy);
+    SStrResult result = sstr_vconcat(dest, policy, args);
+    va_end(args);
+    return result;
+}
+
+SStrResult sstr_array_init(SStr *arr, size_t n, char *block, size_t slot_size)
+{
+    if ((arr == NULL || block == NULL) && n > 0) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (slot_size == 0 || n > SIZE_MAX / slot_size) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    /* Narrow length fields cannot describe the whole of a larger slot */
+    size_t capacity = (slot_size > SSTR_LENGTH_MAX ? SSTR_LENGTH_MAX : slot_size) - 1;
+
+    for (size_t i = 0; i < n; i++) {
+        char *slot = block + i * slot_size;
+        slot[0] = '\0';
+        arr[i].data = slot;
+        arr[i].capacity = capacity;
+        arr[i].length = 0;
+#if SSTR_ENABLE_GROWABLE
+        arr[i].allocator = NULL;
+#endif
+    }
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_array_clear(SStr *arr, size_t n)
+{
+    if (arr == NULL && n > 0) {
+        return SSTR_ERROR_NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (arr[i].data == NULL) {
+            return SSTR_ERROR_NULL;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        arr[i].length = 0;
+        arr[i].data[0] = '\0';
+    }
+
+    return SSTR_SUCCESS;
+}
+
+static inline SStrResult sstr_array_copy_views_impl(SStr *arr, const SStrView *views, size_t n,
+                                                    SStrTruncationPolicy policy)
+{
+    if ((arr == NULL || views == NULL) && n > 0) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Validate the whole table first, so that a failure changes no entry */
+    for (size_t i = 0; i < n; i++) {
+        if (arr[i].data == NULL || views[i].data == NULL) {
+            return SSTR_ERROR_NULL;
+        }
+        if (policy == SSTR_ERROR && views[i].length > arr[i].capacity) {
+            SSTR_STAT(COPY, OVERFLOW, &arr[i], 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t copy_len = views[i].length;
+        if (copy_len > arr[i].capacity) {
+            SSTR_STAT(COPY, TRUNCATION, &arr[i], 0);
+            copy_len = arr[i].capacity;
+        }
+
+        /* A view may point into its own entry */
+        memmove(arr[i].data, views[i].data, copy_len);
+        arr[i].data[copy_len] = '\0';
+        arr[i].length = copy_len;
+        SSTR_STAT(COPY, WRITE, &arr[i], copy_len);
+    }
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_array_copy_views(SStr *arr, const SStrView *views, size_t n)
+{
+    return sstr_array_copy_views_impl(arr, views, n, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_array_copy_views_ex(SStr *arr, const SStrView *views, size_t n,
+                                    SStrTruncationPolicy policy)
+{
+    if (!sstr_policy_valid(policy)) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return sstr_array_copy_views_impl(arr, views, n, policy);
 }
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/cbmc_stubs.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+SStrResult sstr_arena_init(SStrArena *arena, char *block, size_t size)
+{
+    if (arena == NULL || block == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    arena->base = block;
+    arena->size = size;
+    arena->used = 0;
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_arena_alloc(SStrArena *arena, SStr *s, size_t capacity)
+{
+    if (arena == NULL || arena->base == NULL || s == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Written so that capacity + 1 cannot wrap */
+    if (capacity > SSTR_CAPACITY_MAX || capacity >= arena->size - arena->used) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    s->data = arena->base + arena->used;
+    s->capacity = capacity;
+    s->length = 0;
+    s->data[0] = '\0';
+#if SSTR_ENABLE_GROWABLE
+    s->allocator = NULL;
+#endif
+    arena->used += capacity + 1;
+
+    __CPROVER_assert(arena->used <= arena->size, "Allocation stays within the block");
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_arena_grow(SStrArena *arena, SStr *s, size_t capacity)
+{
+    if (arena == NULL || arena->base == NULL || s == NULL || s->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Only the last allocation ends at the top of the arena. A string below
+     * the block wraps to a large offset and fails the first check. */
+    size_t offset = (size_t)((uintptr_t)s->data - (uintptr_t)arena->base);
+    if (offset >= arena->used || (size_t)s->capacity + 1 != arena->used - offset) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    if (capacity <= s->capacity) {
+        return SSTR_SUCCESS;
+    }
+
+    if (capacity > SSTR_CAPACITY_MAX || capacity - s->capacity > arena->size - arena->used) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    arena->used += capacity - s->capacity;
+    s->capacity = capacity;
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_arena_reset(SStrArena *arena)
+{
+    if (arena == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    arena->used = 0;
+
+    return SSTR_SUCCESS;
+}
+
+size_t sstr_arena_available(const SStrArena *arena)
+{
+    if (arena == NULL) {
+        return 0;
+    }
+
+    return arena->size - arena->used;
+}
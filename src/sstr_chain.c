@@ -0,0 +1,236 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/cbmc_stubs.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <string.h>
+
+/* The last segment, if it ends exactly at p and so can be extended */
+static SStrView *sstr_chain_tail_at(SStrChain *chain, const char *p)
+{
+    if (chain->count == chain->first) {
+        return NULL;
+    }
+
+    SStrView *last = &chain->segments[chain->count - 1];
+    return last->data + last->length == p ? last : NULL;
+}
+
+/* Claim a new segment for piece */
+static SStrResult sstr_chain_push(SStrChain *chain, SStrView piece)
+{
+    if (chain->count == chain->capacity) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    chain->segments[chain->count++] = piece;
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_chain_init(SStrChain *chain, SStrView *segments, size_t segment_count,
+                           char *scratch, size_t scratch_size)
+{
+    if (chain == NULL || segments == NULL || scratch == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    SStrResult result = sstr_init(&chain->scratch, scratch, scratch_size);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    chain->segments = segments;
+    chain->capacity = segment_count;
+    chain->first = 0;
+    chain->count = 0;
+    chain->length = 0;
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_chain_append_copy(SStrChain *chain, SStrView piece)
+{
+    if (chain == NULL || chain->segments == NULL || (piece.data == NULL && piece.length > 0)) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (piece.length == 0) {
+        return SSTR_SUCCESS;
+    }
+
+    SStr *scratch = &chain->scratch;
+    if (piece.length > (size_t)scratch->capacity - scratch->length) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    char *dst = scratch->data + scratch->length;
+    SStrView *tail = sstr_chain_tail_at(chain, dst);
+
+    if (tail != NULL) {
+        tail->length += piece.length;
+    } else {
+        SStrView segment;
+        segment.data = dst;
+        segment.length = piece.length;
+        SStrResult result = sstr_chain_push(chain, segment);
+        if (result != SSTR_SUCCESS) {
+            return result;
+        }
+    }
+
+    memcpy(dst, piece.data, piece.length);
+    scratch->length += piece.length;
+    scratch->data[scratch->length] = '\0';
+    chain->length += piece.length;
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_chain_append_view(SStrChain *chain, SStrView piece)
+{
+    if (chain == NULL || chain->segments == NULL || (piece.data == NULL && piece.length > 0)) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (piece.length == 0) {
+        return SSTR_SUCCESS;
+    }
+
+    SStrView *tail = sstr_chain_tail_at(chain, piece.data);
+    if (tail != NULL) {
+        tail->length += piece.length;
+        chain->length += piece.length;
+        return SSTR_SUCCESS;
+    }
+
+    if (piece.length <= SSTR_CHAIN_COPY_MAX &&
+        piece.length <= (size_t)chain->scratch.capacity - chain->scratch.length) {
+        return sstr_chain_append_copy(chain, piece);
+    }
+
+    SStrResult result = sstr_chain_push(chain, piece);
+    if (result == SSTR_SUCCESS) {
+        chain->length += piece.length;
+    }
+
+    return result;
+}
+
+SStrResult sstr_chain_append(SStrChain *chain, const char *src)
+{
+    if (src == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    SStrView view = sstr_view_from_cstr(src);
+    if (view.data == NULL) {
+        return SSTR_ERROR_OVERFLOW; /* Longer than SSTR_MAX_SIZE */
+    }
+
+    return sstr_chain_append_view(chain, view);
+}
+
+SStrResult sstr_chain_append_sstr(SStrChain *chain, const SStr *src)
+{
+    if (src == NULL || src->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    return sstr_chain_append_view(chain, sstr_view_from_sstr(src));
+}
+
+SStrResult sstr_chain_consume(SStrChain *chain, size_t bytes)
+{
+    if (chain == NULL || chain->segments == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (bytes > chain->length) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    chain->length -= bytes;
+
+    while (bytes > 0) {
+        SStrView *segment = &chain->segments[chain->first];
+        if (bytes < segment->length) {
+            segment->data += bytes;
+            segment->length -= bytes;
+            break;
+        }
+        bytes -= segment->length;
+        chain->first++;
+    }
+
+    /* Nothing references the scratch buffer once every segment is gone */
+    if (chain->first == chain->count) {
+        return sstr_chain_reset(chain);
+    }
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_chain_reset(SStrChain *chain)
+{
+    if (chain == NULL || chain->segments == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    chain->first = 0;
+    chain->count = 0;
+    chain->length = 0;
+
+    return sstr_clear(&chain->scratch);
+}
+
+SStrResult sstr_chain_flatten(const SStrChain *chain, SStr *dest)
+{
+    if (chain == NULL || chain->segments == NULL || dest == NULL || dest->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* sstr_append_many checks the total before writing anything, so a
+     * rejected copy only needs the old length restored */
+    size_t length = dest->length;
+    dest->length = 0;
+
+    SStrResult result =
+        sstr_append_many(dest, chain->segments + chain->first, chain->count - chain->first);
+    if (result != SSTR_SUCCESS) {
+        dest->length = length;
+    }
+
+    return result;
+}
+
+#if SSTR_ENABLE_IOVEC
+size_t sstr_chain_iov(const SStrChain *chain, struct iovec *iov, size_t n)
+{
+    if (chain == NULL || chain->segments == NULL || iov == NULL) {
+        return 0;
+    }
+
+    size_t count = chain->count - chain->first;
+    if (count > n) {
+        count = n;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const SStrView *segment = &chain->segments[chain->first + i];
+        /* writev and sendmsg only read the buffers */
+        iov[i].iov_base = (void *)segment->data;
+        iov[i].iov_len = segment->length;
+    }
+
+    return count;
+}
+#endif
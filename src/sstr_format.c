@@ -10,16 +10,572 @@
 
 #include "../include/sstr/sstr.h"
 #include "../include/sstr/sstr_config.h"
-#include <ctype.h>
+#include <limits.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
-/* Internal helper to safely format strings */
+/* Returned by the native engine for conversions it does not implement */
+#define SSTR_FORMAT_UNSUPPORTED (-100)
+
+/* Conversion flags */
+#define SSTR_FLAG_LEFT  0x01 /* '-' */
+#define SSTR_FLAG_PLUS  0x02 /* '+' */
+#define SSTR_FLAG_SPACE 0x04 /* ' ' */
+#define SSTR_FLAG_ALT   0x08 /* '#' */
+#define SSTR_FLAG_ZERO  0x10 /* '0' */
+
+/* Length modifiers */
+enum {
+    SSTR_LEN_NONE,
+    SSTR_LEN_HH,
+    SSTR_LEN_H,
+    SSTR_LEN_L,
+    SSTR_LEN_LL,
+    SSTR_LEN_Z,
+    SSTR_LEN_J,
+    SSTR_LEN_T
+};
+
+/* Output window for the native engine. Characters that do not fit are
+ * counted but not stored, mirroring the return value of vsnprintf. With a
+ * sink set, characters are written to the sink instead of the window. */
+typedef struct {
+    char *buf;
+    size_t limit;   /* Characters that may be stored, excluding the terminator */
+    size_t pos;     /* Characters produced so far */
+    SStrSink *sink; /* Receives the output when set */
+    int error;      /* First sink error, after which output is dropped */
+} SStrFormatOut;
+
+/* "00" to "99", used to emit decimal digits two at a time */
+static const char sstr_digit_pairs[201] = "00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899";
+
+static const char sstr_hex_lower[17] = "0123456789abcdef";
+static const char sstr_hex_upper[17] = "0123456789ABCDEF";
+
+/* Enough for the decimal digits of the widest integer type */
+#define SSTR_INT_DIGITS_MAX (sizeof(uintmax_t) * 3)
+
+/* Fill the sink buffer with n copies of c, flushing as it fills */
+static void format_sink_pad(SStrFormatOut *out, char c, size_t n)
+{
+    SStr *buffer = &out->sink->buffer;
+
+    while (n > 0 && out->error == SSTR_SUCCESS) {
+        size_t room = buffer->capacity - buffer->length;
+        if (room == 0) {
+            out->error = sstr_sink_flush(out->sink);
+            continue;
+        }
+
+        size_t chunk = n < room ? n : room;
+        memset(buffer->data + buffer->length, c, chunk);
+        buffer->length += chunk;
+        n -= chunk;
+    }
+}
+
+static void format_put(SStrFormatOut *out, const char *src, size_t n)
+{
+    if (out->sink != NULL) {
+        if (out->error == SSTR_SUCCESS) {
+            out->error = sstr_sink_write(out->sink, src, n);
+        }
+        out->pos += n;
+        return;
+    }
+
+    if (out->pos < out->limit) {
+        size_t room = out->limit - out->pos;
+        memcpy(out->buf + out->pos, src, n < room ? n : room);
+    }
+    out->pos += n;
+}
+
+static void format_pad(SStrFormatOut *out, char c, size_t n)
+{
+    if (out->sink != NULL) {
+        format_sink_pad(out, c, n);
+        out->pos += n;
+        return;
+    }
+
+    if (out->pos < out->limit) {
+        size_t room = out->limit - out->pos;
+        memset(out->buf + out->pos, c, n < room ? n : room);
+    }
+    out->pos += n;
+}
+
+/* Write the decimal digits of value ending at end, returning the first digit */
+static char *format_decimal(char *end, uintmax_t value)
+{
+    while (value >= 100) {
+        size_t idx = (size_t)(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        end[0] = sstr_digit_pairs[idx];
+        end[1] = sstr_digit_pairs[idx + 1];
+    }
+
+    if (value >= 10) {
+        size_t idx = (size_t)value * 2;
+        end -= 2;
+        end[0] = sstr_digit_pairs[idx];
+        end[1] = sstr_digit_pairs[idx + 1];
+    } else {
+        *--end = (char)('0' + value);
+    }
+
+    return end;
+}
+
+/* Write the hex digits of value ending at end, returning the first digit */
+static char *format_hex(char *end, uintmax_t value, const char *digits)
+{
+    do {
+        *--end = digits[value & 0xF];
+        value >>= 4;
+    } while (value != 0);
+
+    return end;
+}
+
+#if SSTR_ENABLE_FORMAT
+/* Everything from here to the integer appenders is the printf-style API */
+
+/* Parse the conversion specification following a '%'
+ * Returns a pointer past the conversion character, or NULL if the
+ * specification is malformed or not implemented by the native engine */
+static const char *parse_format_spec(const char *p, SStrFormatSpec *spec)
+{
+    spec->flags = 0;
+    spec->length = SSTR_LEN_NONE;
+    spec->width = 0;
+    spec->precision = -1;
+
+    for (;; p++) {
+        if (*p == '-') {
+            spec->flags |= SSTR_FLAG_LEFT;
+        } else if (*p == '+') {
+            spec->flags |= SSTR_FLAG_PLUS;
+        } else if (*p == ' ') {
+            spec->flags |= SSTR_FLAG_SPACE;
+        } else if (*p == '#') {
+            spec->flags |= SSTR_FLAG_ALT;
+        } else if (*p == '0') {
+            spec->flags |= SSTR_FLAG_ZERO;
+        } else {
+            break;
+        }
+    }
+
+    while (*p >= '0' && *p <= '9') {
+        if (spec->width > (INT_MAX - 9) / 10) {
+            return NULL;
+        }
+        spec->width = spec->width * 10 + (*p++ - '0');
+    }
+
+    if (*p == '.') {
+        p++;
+        spec->precision = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (spec->precision > (INT_MAX - 9) / 10) {
+                return NULL;
+            }
+            spec->precision = spec->precision * 10 + (*p++ - '0');
+        }
+    }
+
+    switch (*p) {
+    case 'h':
+        if (p[1] == 'h') {
+            spec->length = SSTR_LEN_HH;
+            p++;
+        } else {
+            spec->length = SSTR_LEN_H;
+        }
+        p++;
+        break;
+    case 'l':
+        if (p[1] == 'l') {
+            spec->length = SSTR_LEN_LL;
+            p++;
+        } else {
+            spec->length = SSTR_LEN_L;
+        }
+        p++;
+        break;
+    case 'z':
+        spec->length = SSTR_LEN_Z;
+        p++;
+        break;
+    case 'j':
+        spec->length = SSTR_LEN_J;
+        p++;
+        break;
+    case 't':
+        spec->length = SSTR_LEN_T;
+        p++;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case '%':
+        break;
+    case 'c':
+    case 's':
+        /* Wide characters and strings are not supported */
+        if (spec->length != SSTR_LEN_NONE) {
+            return NULL;
+        }
+        break;
+    default:
+        return NULL;
+    }
+
+    spec->conversion = *p;
+    return p + 1;
+}
+
+/* Emit an integer conversion from its magnitude and sign */
+static void format_integer(SStrFormatOut *out, const SStrFormatSpec *spec, uintmax_t value,
+                           int negative)
+{
+    char digits[SSTR_INT_DIGITS_MAX];
+    char *end = digits + sizeof(digits);
+    char *start;
+    char prefix[2];
+    size_t prefix_len = 0;
+
+    if (spec->conversion == 'x') {
+        start = format_hex(end, value, sstr_hex_lower);
+    } else if (spec->conversion == 'X') {
+        start = format_hex(end, value, sstr_hex_upper);
+    } else {
+        start = format_decimal(end, value);
+    }
+
+    size_t digit_len = (size_t)(end - start);
+
+    /* An explicit zero precision prints nothing for a zero value */
+    if (spec->precision == 0 && value == 0) {
+        digit_len = 0;
+    }
+
+    if (negative) {
+        prefix[prefix_len++] = '-';
+    } else if (spec->conversion == 'd' || spec->conversion == 'i') {
+        if (spec->flags & SSTR_FLAG_PLUS) {
+            prefix[prefix_len++] = '+';
+        } else if (spec->flags & SSTR_FLAG_SPACE) {
+            prefix[prefix_len++] = ' ';
+        }
+    } else if ((spec->flags & SSTR_FLAG_ALT) && value != 0 &&
+               (spec->conversion == 'x' || spec->conversion == 'X')) {
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = spec->conversion;
+    }
+
+    size_t precision_zeros = 0;
+    if (spec->precision > 0 && (size_t)spec->precision > digit_len) {
+        precision_zeros = (size_t)spec->precision - digit_len;
+    }
+
+    size_t body_len = prefix_len + precision_zeros + digit_len;
+    size_t padding = 0;
+    if ((size_t)spec->width > body_len) {
+        padding = (size_t)spec->width - body_len;
+    }
+
+    if (spec->flags & SSTR_FLAG_LEFT) {
+        format_put(out, prefix, prefix_len);
+        format_pad(out, '0', precision_zeros);
+        format_put(out, start, digit_len);
+        format_pad(out, ' ', padding);
+    } else if ((spec->flags & SSTR_FLAG_ZERO) && spec->precision < 0) {
+        format_put(out, prefix, prefix_len);
+        format_pad(out, '0', padding + precision_zeros);
+        format_put(out, start, digit_len);
+    } else {
+        format_pad(out, ' ', padding);
+        format_put(out, prefix, prefix_len);
+        format_pad(out, '0', precision_zeros);
+        format_put(out, start, digit_len);
+    }
+}
+
+/* Emit text padded to the field width */
+static void format_text(SStrFormatOut *out, const SStrFormatSpec *spec, const char *text,
+                        size_t len)
+{
+    size_t padding = (size_t)spec->width > len ? (size_t)spec->width - len : 0;
+
+    if (spec->flags & SSTR_FLAG_LEFT) {
+        format_put(out, text, len);
+        format_pad(out, ' ', padding);
+    } else {
+        format_pad(out, ' ', padding);
+        format_put(out, text, len);
+    }
+}
+
+/* Fetch the argument for one conversion and emit it */
+static int format_argument(SStrFormatOut *out, const SStrFormatSpec *spec, va_list *args)
+{
+    switch (spec->conversion) {
+    case 'd':
+    case 'i': {
+        intmax_t value;
+        switch (spec->length) {
+        case SSTR_LEN_HH:
+            value = (signed char)va_arg(*args, int);
+            break;
+        case SSTR_LEN_H:
+            value = (short)va_arg(*args, int);
+            break;
+        case SSTR_LEN_L:
+            value = va_arg(*args, long);
+            break;
+        case SSTR_LEN_LL:
+            value = va_arg(*args, long long);
+            break;
+        case SSTR_LEN_Z:
+        case SSTR_LEN_T:
+            value = va_arg(*args, ptrdiff_t);
+            break;
+        case SSTR_LEN_J:
+            value = va_arg(*args, intmax_t);
+            break;
+        default:
+            value = va_arg(*args, int);
+            break;
+        }
+        /* Negate in the unsigned domain so INTMAX_MIN is representable */
+        uintmax_t magnitude = value < 0 ? (uintmax_t)0 - (uintmax_t)value : (uintmax_t)value;
+        format_integer(out, spec, magnitude, value < 0);
+        return SSTR_SUCCESS;
+    }
+    case 'u':
+    case 'x':
+    case 'X': {
+        uintmax_t value;
+        switch (spec->length) {
+        case SSTR_LEN_HH:
+            value = (unsigned char)va_arg(*args, unsigned int);
+            break;
+        case SSTR_LEN_H:
+            value = (unsigned short)va_arg(*args, unsigned int);
+            break;
+        case SSTR_LEN_L:
+            value = va_arg(*args, unsigned long);
+            break;
+        case SSTR_LEN_LL:
+            value = va_arg(*args, unsigned long long);
+            break;
+        case SSTR_LEN_Z:
+            value = va_arg(*args, size_t);
+            break;
+        case SSTR_LEN_T:
+            value = (size_t)va_arg(*args, ptrdiff_t);
+            break;
+        case SSTR_LEN_J:
+            value = va_arg(*args, uintmax_t);
+            break;
+        default:
+            value = va_arg(*args, unsigned int);
+            break;
+        }
+        format_integer(out, spec, value, 0);
+        return SSTR_SUCCESS;
+    }
+    case 'c': {
+        char c = (char)va_arg(*args, int);
+        format_text(out, spec, &c, 1);
+        return SSTR_SUCCESS;
+    }
+    case 's': {
+        const char *str = va_arg(*args, const char *);
+        if (str == NULL) {
+            return SSTR_ERROR_ARGUMENT;
+        }
+        size_t len;
+        if (spec->precision >= 0) {
+            const char *nul = (const char *)memchr(str, '\0', (size_t)spec->precision);
+            len = nul != NULL ? (size_t)(nul - str) : (size_t)spec->precision;
+        } else {
+            len = strlen(str);
+        }
+        format_text(out, spec, str, len);
+        return SSTR_SUCCESS;
+    }
+    default: /* '%' */
+        format_put(out, "%", 1);
+        return SSTR_SUCCESS;
+    }
+}
+
+/* Terminate the output window and produce the vsnprintf-style result */
+static int format_finish(SStrFormatOut *out, char *str, size_t size, int result)
+{
+    if (result == SSTR_SUCCESS && out->pos > INT_MAX) {
+        result = SSTR_ERROR_FORMAT;
+    }
+
+    if (size > 0) {
+        str[out->pos < out->limit ? out->pos : out->limit] = '\0';
+    }
+
+    return result == SSTR_SUCCESS ? (int)out->pos : result;
+}
+
+/* Run a compiled program, returning the untruncated output length or a
+ * negative SStrResult */
+static int program_vsnprintf(char *str, size_t size, const SStrFormatProgram *prog, va_list ap)
+{
+    SStrFormatOut out;
+    out.buf = str;
+    out.limit = size > 0 ? size - 1 : 0;
+    out.pos = 0;
+    out.sink = NULL;
+    out.error = SSTR_SUCCESS;
+
+    va_list args;
+    va_copy(args, ap);
+
+    int result = SSTR_SUCCESS;
+
+    for (size_t i = 0; i < prog->op_count; i++) {
+        const SStrFormatOp *op = &prog->ops[i];
+
+        format_put(&out, op->literal, op->literal_length);
+
+        if (op->spec.conversion != '\0') {
+            result = format_argument(&out, &op->spec, &args);
+            if (result != SSTR_SUCCESS) {
+                break;
+            }
+        }
+
+        /* The output length must be representable in the int return value */
+        if (out.pos > INT_MAX) {
+            result = SSTR_ERROR_FORMAT;
+            break;
+        }
+    }
+
+    va_end(args);
+
+    return format_finish(&out, str, size, result);
+}
+
+#if SSTR_NATIVE_FORMAT
+/* Run the native engine into out. Returns SSTR_SUCCESS,
+ * SSTR_FORMAT_UNSUPPORTED for conversions it does not implement, or a
+ * negative SStrResult. */
+static int native_run(SStrFormatOut *out, const char *format, va_list ap)
+{
+    va_list args;
+    va_copy(args, ap);
+
+    const char *p = format;
+    int result = SSTR_SUCCESS;
+
+    while (*p != '\0') {
+        /* Copy the literal run up to the next conversion */
+        const char *literal = p;
+        while (*p != '\0' && *p != '%') {
+            p++;
+        }
+        format_put(out, literal, (size_t)(p - literal));
+
+        if (*p == '\0') {
+            break;
+        }
+
+        SStrFormatSpec spec;
+        p = parse_format_spec(p + 1, &spec);
+        if (p == NULL) {
+            result = SSTR_FORMAT_UNSUPPORTED;
+            break;
+        }
+
+        result = format_argument(out, &spec, &args);
+        if (result != SSTR_SUCCESS) {
+            break;
+        }
+
+        /* The output length must be representable in the int return value */
+        if (out->pos > INT_MAX) {
+            result = SSTR_ERROR_FORMAT;
+            break;
+        }
+    }
+
+    va_end(args);
+
+    return result;
+}
+
+/* vsnprintf replacement for the conversions in SSTR_ALLOWED_SPECIFIERS
+ * Returns the untruncated output length, SSTR_FORMAT_UNSUPPORTED for
+ * conversions it does not implement, or a negative SStrResult */
+static int native_vsnprintf(char *str, size_t size, const char *format, va_list ap)
+{
+    SStrFormatOut out;
+    out.buf = str;
+    out.limit = size > 0 ? size - 1 : 0;
+    out.pos = 0;
+    out.sink = NULL;
+    out.error = SSTR_SUCCESS;
+
+    int result = native_run(&out, format, ap);
+
+    return format_finish(&out, str, size, result);
+}
+
+/* Whether the native engine implements every conversion in format */
+static int native_supported(const char *format)
+{
+    const char *p = format;
+
+    while ((p = strchr(p, '%')) != NULL) {
+        SStrFormatSpec spec;
+        p = parse_format_spec(p + 1, &spec);
+        if (p == NULL) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+#endif
+
+/* Internal helper to safely format strings
+ * Returns the untruncated output length or a negative SStrResult */
 static int safe_vsnprintf(char *str, size_t size, const char *format, va_list ap)
 {
     if (str == NULL || format == NULL) {
-        return -1;
+        return SSTR_ERROR_NULL;
     }
 
     /* Ensure null termination even if buffer size is 0 */
@@ -27,14 +583,30 @@ static int safe_vsnprintf(char *str, size_t size, const char *format, va_list ap
         str[0] = '\0';
     }
 
+#if SSTR_NATIVE_FORMAT
+    int native_result = native_vsnprintf(str, size, format, ap);
+    if (native_result != SSTR_FORMAT_UNSUPPORTED) {
+        return native_result;
+    }
+#if !SSTR_FORMAT_LIBC_FALLBACK
+    return SSTR_ERROR_FORMAT;
+#endif
+#endif
+
+#if !SSTR_NATIVE_FORMAT || SSTR_FORMAT_LIBC_FALLBACK
     int result = vsnprintf(str, size, format, ap);
 
+    if (result < 0) {
+        return SSTR_ERROR_FORMAT;
+    }
+
     /* Ensure null termination even if vsnprintf implementation is broken */
-    if (result >= 0 && (size_t)result >= size && size > 0) {
+    if ((size_t)result >= size && size > 0) {
         str[size - 1] = '\0';
     }
 
     return result;
+#endif
 }
 
 #if SSTR_VALIDATE_FORMAT
@@ -47,14 +619,8 @@ static int validate_format_string(const char *fmt)
 
     const char *ptr = fmt;
 
-    while (*ptr) {
-        /* Find the next '%' character */
-        if (*ptr != '%') {
-            ptr++;
-            continue;
-        }
-
-        /* Process a % character */
+    /* Jump from one '%' to the next; literal runs need no checking */
+    while ((ptr = strchr(ptr, '%')) != NULL) {
         ptr++; /* Move past '%' */
 
         /* Handle %% escape sequence */
@@ -74,14 +640,14 @@ static int validate_format_string(const char *fmt)
         }
 
         /* Skip width: digits */
-        while (isdigit((unsigned char)*ptr)) {
+        while (*ptr >= '0' && *ptr <= '9') {
             ptr++;
         }
 
         /* Skip precision: .digits */
         if (*ptr == '.') {
             ptr++;
-            while (isdigit((unsigned char)*ptr)) {
+            while (*ptr >= '0' && *ptr <= '9') {
                 ptr++;
             }
         }
@@ -115,7 +681,269 @@ static int validate_format_string(const char *fmt)
 }
 #endif
 
+/* Format from either a format string or a compiled program */
+static int format_into(char *str, size_t size, const char *fmt, const SStrFormatProgram *prog,
+                       va_list ap)
+{
+    if (prog != NULL) {
+        return program_vsnprintf(str, size, prog, ap);
+    }
+
+    return safe_vsnprintf(str, size, fmt, ap);
+}
+
+/* Format into dest and commit the result according to the truncation policy.
+ * Exactly one of fmt and prog is used; both have already been validated. */
+static int format_commit(SStr *dest, const char *fmt, const SStrFormatProgram *prog,
+                         va_list args, SStrTruncationPolicy policy)
+{
+    if (dest->length > 0) {
+        /* Format into the free tail past the terminator so that a format
+         * error or a rejected overflow leaves the current contents untouched.
+         * A full buffer has an empty tail, in which case this first pass only
+         * measures. */
+        char *tail = dest->data + dest->length + 1;
+        size_t tail_size = dest->capacity - dest->length;
+
+        va_list args_copy;
+        va_copy(args_copy, args);
+
+        int result = format_into(tail, tail_size, fmt, prog, args);
+        if (result < 0) {
+            va_end(args_copy);
+            return result;
+        }
+
+        if ((size_t)result < tail_size) {
+            /* Commit: slide the output (and its terminator) to the front */
+            memmove(dest->data, tail, (size_t)result + 1);
+            dest->length = (size_t)result;
+            va_end(args_copy);
+            return result;
+        }
+
+        if ((size_t)result > dest->capacity && policy == SSTR_ERROR) {
+            va_end(args_copy);
+            return SSTR_ERROR_OVERFLOW;
+        }
+
+        /* Fits the buffer but not the tail, or is truncated to the buffer,
+         * so a second pass is unavoidable */
+        result = format_into(dest->data, dest->capacity + 1, fmt, prog, args_copy);
+        va_end(args_copy);
+
+        if (result >= 0) {
+            dest->length = (size_t)result > dest->capacity ? dest->capacity : (size_t)result;
+        }
+
+        return result;
+    }
+
+    /* The string is empty: single pass straight into the buffer; the return
+     * value tells us whether the output fit */
+    int result = format_into(dest->data, dest->capacity + 1, fmt, prog, args);
+
+    if (result < 0) {
+        /* Restoring the terminator of the empty string restores it */
+        dest->data[0] = '\0';
+        return result;
+    }
+
+    if ((size_t)result > dest->capacity) {
+        if (policy == SSTR_ERROR) {
+            /* The string was empty, so restoring the terminator restores it */
+            dest->data[0] = '\0';
+            return SSTR_ERROR_OVERFLOW;
+        }
+
+        /* Truncated output */
+        dest->length = dest->capacity;
+        return result;
+    }
+
+    dest->length = (size_t)result;
+
+    return result;
+}
+
+/* Format into the space after the current content. The terminator at
+ * dest->length is the first byte overwritten, so a failed or rejected
+ * append only needs it restored to leave dest unchanged. */
+static int format_append(SStr *dest, const char *fmt, const SStrFormatProgram *prog,
+                         va_list args, SStrTruncationPolicy policy)
+{
+    char *tail = dest->data + dest->length;
+    size_t available = dest->capacity - dest->length;
+
+    int result = format_into(tail, available + 1, fmt, prog, args);
+
+    if (result < 0) {
+        *tail = '\0';
+        return result;
+    }
+
+    if ((size_t)result > available) {
+        if (policy == SSTR_ERROR) {
+            *tail = '\0';
+            return SSTR_ERROR_OVERFLOW;
+        }
+
+        /* Truncated output */
+        dest->length = dest->capacity;
+        return result;
+    }
+
+    dest->length += (size_t)result;
+
+    return result;
+}
+
+#if SSTR_ENABLE_STATS
+/* Count a finished format call whose output started at offset start of
+ * dest; result is the full output length or a negative SStrResult */
+static int format_stats(const SStr *dest, size_t start, int result)
+{
+    if (result == SSTR_ERROR_OVERFLOW) {
+        sstr_stats_record(SSTR_STATS_FORMAT, SSTR_STATS_OVERFLOW, dest, 0);
+    } else if (result >= 0) {
+        size_t written = dest->length - start;
+        if ((size_t)result > written) {
+            sstr_stats_record(SSTR_STATS_FORMAT, SSTR_STATS_TRUNCATION, dest, 0);
+        }
+        sstr_stats_record(SSTR_STATS_FORMAT, SSTR_STATS_WRITE, dest, written);
+    }
+
+    return result;
+}
+#else
+#define format_stats(dest, start, result) ((void)(start), (result))
+#endif
+
+#if SSTR_ENABLE_GROWABLE
+/* Grow dest to hold length characters of output at offset and format them.
+ * %s arguments may point into dest's buffer, so the output goes into a new
+ * buffer, sized as sstr_reserve would, before the old one is released.
+ * Returns SSTR_ERROR_OVERFLOW without reading args if allocation fails. */
+static int format_grow(SStr *dest, size_t offset, size_t length, const char *fmt,
+                       const SStrFormatProgram *prog, va_list args)
+{
+    size_t capacity = offset + length;
+    size_t grown = dest->capacity < SSTR_CAPACITY_MAX / 2 ? (size_t)dest->capacity * 2 + 1
+                                                          : SSTR_CAPACITY_MAX;
+    if (grown < capacity) {
+        grown = capacity;
+    }
+
+    char *data = (char *)dest->allocator->resize(dest->allocator->ctx, NULL, 0, grown + 1);
+    if (data == NULL) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    memcpy(data, dest->data, offset);
+    int result = format_into(data + offset, grown - offset + 1, fmt, prog, args);
+    dest->allocator->resize(dest->allocator->ctx, dest->data, dest->capacity + 1, 0);
+
+    dest->data = data;
+    dest->capacity = grown;
+    dest->length = offset + (size_t)result;
+    return result;
+}
+
+/* Format into a growable string, replacing its content or appending to it.
+ * Output that does not fit is measured, dest grown to hold it and the
+ * format run again; the policy only applies if growing fails. */
+static int format_growable(SStr *dest, int append, const char *fmt,
+                           const SStrFormatProgram *prog, va_list args,
+                           SStrTruncationPolicy policy)
+{
+    size_t offset = append ? dest->length : 0;
+    va_list measure_args;
+    va_list retry_args;
+    va_copy(measure_args, args);
+    va_copy(retry_args, args);
+
+    int result = append ? format_append(dest, fmt, prog, args, SSTR_ERROR)
+                        : format_commit(dest, fmt, prog, args, SSTR_ERROR);
+
+    if (result == SSTR_ERROR_OVERFLOW) {
+        char probe;
+        result = format_into(&probe, 0, fmt, prog, measure_args);
+
+        if (result >= 0) {
+            int grown = SSTR_ERROR_OVERFLOW;
+            if ((size_t)result <= SSTR_CAPACITY_MAX - offset) {
+                grown = format_grow(dest, offset, (size_t)result, fmt, prog, retry_args);
+            }
+            result = grown >= 0 ? grown
+                     : append   ? format_append(dest, fmt, prog, retry_args, policy)
+                                : format_commit(dest, fmt, prog, retry_args, policy);
+        }
+    }
+
+    va_end(retry_args);
+    va_end(measure_args);
+
+    return result;
+}
+#endif
+
+static int vformat_impl(SStr *dest, const char *fmt, va_list args, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL || fmt == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#if SSTR_VALIDATE_FORMAT
+    /* Validate format string - only allow approved specifiers */
+    int validation_result = validate_format_string(fmt);
+    if (validation_result != SSTR_SUCCESS) {
+        return validation_result;
+    }
+#endif
+
+#if SSTR_ENABLE_GROWABLE
+    if (dest->allocator != NULL) {
+        return format_stats(dest, 0, format_growable(dest, 0, fmt, NULL, args, policy));
+    }
+#endif
+
+    return format_stats(dest, 0, format_commit(dest, fmt, NULL, args, policy));
+}
+
 int sstr_vformat(SStr *dest, const char *fmt, va_list args)
+{
+    return vformat_impl(dest, fmt, args, SSTR_DEFAULT_POLICY);
+}
+
+int sstr_format(SStr *dest, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = sstr_vformat(dest, fmt, args);
+    va_end(args);
+    return result;
+}
+
+int sstr_vformat_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, va_list args)
+{
+    if (policy != SSTR_ERROR && policy != SSTR_TRUNCATE) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return vformat_impl(dest, fmt, args, policy);
+}
+
+int sstr_format_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = sstr_vformat_ex(dest, policy, fmt, args);
+    va_end(args);
+    return result;
+}
+
+static int append_vformat_impl(SStr *dest, const char *fmt, va_list args,
+                               SStrTruncationPolicy policy)
 {
     if (dest == NULL || dest->data == NULL || fmt == NULL) {
         return SSTR_ERROR_NULL;
@@ -129,44 +957,430 @@ int sstr_vformat(SStr *dest, const char *fmt, va_list args)
     }
 #endif
 
-    va_list args_copy;
-    va_copy(args_copy, args);
+    size_t start = dest->length;
 
-    /* First, try the format to get the required length */
-    int needed_length = vsnprintf(NULL, 0, fmt, args_copy);
-    va_end(args_copy);
+#if SSTR_ENABLE_GROWABLE
+    if (dest->allocator != NULL) {
+        return format_stats(dest, start, format_growable(dest, 1, fmt, NULL, args, policy));
+    }
+#endif
 
-    if (needed_length < 0) {
-        return SSTR_ERROR_FORMAT;
+    return format_stats(dest, start, format_append(dest, fmt, NULL, args, policy));
+}
+
+int sstr_append_vformat(SStr *dest, const char *fmt, va_list args)
+{
+    return append_vformat_impl(dest, fmt, args, SSTR_DEFAULT_POLICY);
+}
+
+int sstr_append_format(SStr *dest, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = sstr_append_vformat(dest, fmt, args);
+    va_end(args);
+    return result;
+}
+
+int sstr_append_vformat_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt,
+                           va_list args)
+{
+    if (policy != SSTR_ERROR && policy != SSTR_TRUNCATE) {
+        return SSTR_ERROR_ARGUMENT;
     }
 
-    /* Check if there's enough space */
-    if ((size_t)needed_length > dest->capacity) {
-#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    return append_vformat_impl(dest, fmt, args, policy);
+}
+
+int sstr_append_format_ex(SStr *dest, SStrTruncationPolicy policy, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = sstr_append_vformat_ex(dest, policy, fmt, args);
+    va_end(args);
+    return result;
+}
+
+/* Stream output larger than the sink buffer through it with the native
+ * engine. Returns the output length or a negative SStrResult. */
+static int format_stream(SStrSink *sink, const char *fmt, va_list args)
+{
+#if SSTR_NATIVE_FORMAT
+    /* Checked up front, as nothing can be taken back once batches are flushed */
+    if (!native_supported(fmt)) {
         return SSTR_ERROR_OVERFLOW;
+    }
+
+    SStrFormatOut out;
+    out.buf = NULL;
+    out.limit = 0;
+    out.pos = 0;
+    out.sink = sink;
+    out.error = SSTR_SUCCESS;
+
+    int result = native_run(&out, fmt, args);
+    if (result == SSTR_SUCCESS) {
+        result = out.error;
+    }
+
+    sink->buffer.data[sink->buffer.length] = '\0';
+
+    return result == SSTR_SUCCESS ? (int)out.pos : result;
 #else
-        /* Truncate the output */
-        int result = safe_vsnprintf(dest->data, dest->capacity + 1, fmt, args);
-        dest->length = dest->capacity;
-        return result;
+    (void)sink;
+    (void)fmt;
+    (void)args;
+    return SSTR_ERROR_OVERFLOW;
 #endif
+}
+
+int sstr_sink_vformat(SStrSink *sink, const char *fmt, va_list args)
+{
+    if (sink == NULL || sink->buffer.data == NULL || fmt == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#if SSTR_VALIDATE_FORMAT
+    int validation_result = validate_format_string(fmt);
+    if (validation_result != SSTR_SUCCESS) {
+        return validation_result;
     }
+#endif
+
+    va_list retry_args;
+    va_list stream_args;
+    va_copy(retry_args, args);
+    va_copy(stream_args, args);
+
+    /* Usually the output fits behind the buffered bytes and no flush is due */
+    int result = format_append(&sink->buffer, fmt, NULL, args, SSTR_ERROR);
 
-    /* Format into the buffer */
-    int result = safe_vsnprintf(dest->data, dest->capacity + 1, fmt, args);
+    if (result == SSTR_ERROR_OVERFLOW) {
+        int buffered = sink->buffer.length > 0;
+        SStrResult flushed = sstr_sink_flush(sink);
 
-    if (result >= 0) {
-        dest->length = (size_t)result;
+        if (flushed != SSTR_SUCCESS) {
+            result = flushed;
+        } else {
+            if (buffered) {
+                result = format_append(&sink->buffer, fmt, NULL, retry_args, SSTR_ERROR);
+            }
+            if (result == SSTR_ERROR_OVERFLOW) {
+                result = format_stream(sink, fmt, stream_args);
+            }
+        }
     }
 
+    va_end(stream_args);
+    va_end(retry_args);
+
     return result;
 }
 
-int sstr_format(SStr *dest, const char *fmt, ...)
+int sstr_sink_format(SStrSink *sink, const char *fmt, ...)
 {
     va_list args;
     va_start(args, fmt);
-    int result = sstr_vformat(dest, fmt, args);
+    int result = sstr_sink_vformat(sink, fmt, args);
     va_end(args);
     return result;
 }
+
+SStrResult sstr_format_compile(SStrFormatProgram *prog, const char *fmt)
+{
+    if (prog == NULL || fmt == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Mark the program invalid until compilation succeeds */
+    prog->op_count = SSTR_FORMAT_MAX_OPS + 1;
+
+#if SSTR_VALIDATE_FORMAT
+    /* Validate format string - only allow approved specifiers */
+    int validation_result = validate_format_string(fmt);
+    if (validation_result != SSTR_SUCCESS) {
+        return (SStrResult)validation_result;
+    }
+#endif
+
+    const char *p = fmt;
+    size_t count = 0;
+
+    while (*p != '\0') {
+        if (count == SSTR_FORMAT_MAX_OPS) {
+            return SSTR_ERROR_OVERFLOW;
+        }
+
+        SStrFormatOp *op = &prog->ops[count++];
+
+        /* Record the literal run up to the next conversion */
+        op->literal = p;
+        while (*p != '\0' && *p != '%') {
+            p++;
+        }
+        op->literal_length = (size_t)(p - op->literal);
+
+        if (*p == '\0') {
+            op->spec.conversion = '\0';
+            break;
+        }
+
+        /* Programs never fall back to vsnprintf, so anything the native
+         * engine does not implement is rejected here */
+        p = parse_format_spec(p + 1, &op->spec);
+        if (p == NULL) {
+            return SSTR_ERROR_FORMAT;
+        }
+    }
+
+    prog->op_count = count;
+
+    return SSTR_SUCCESS;
+}
+
+int sstr_vformat_exec(SStr *dest, const SStrFormatProgram *prog, va_list args)
+{
+    if (dest == NULL || dest->data == NULL || prog == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* Reject programs whose compilation failed */
+    if (prog->op_count > SSTR_FORMAT_MAX_OPS) {
+        return SSTR_ERROR_FORMAT;
+    }
+
+#if SSTR_ENABLE_GROWABLE
+    if (dest->allocator != NULL) {
+        return format_stats(dest, 0,
+                            format_growable(dest, 0, NULL, prog, args, SSTR_DEFAULT_POLICY));
+    }
+#endif
+
+    return format_stats(dest, 0, format_commit(dest, NULL, prog, args, SSTR_DEFAULT_POLICY));
+}
+
+int sstr_format_exec(SStr *dest, const SStrFormatProgram *prog, ...)
+{
+    va_list args;
+    va_start(args, prog);
+    int result = sstr_vformat_exec(dest, prog, args);
+    va_end(args);
+    return result;
+}
+
+int sstr_vformat_unchecked(SStr *dest, const char *fmt, va_list args)
+{
+    if (dest == NULL || dest->data == NULL || fmt == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+#if SSTR_ENABLE_GROWABLE
+    if (dest->allocator != NULL) {
+        return format_stats(dest, 0,
+                            format_growable(dest, 0, fmt, NULL, args, SSTR_DEFAULT_POLICY));
+    }
+#endif
+
+    return format_stats(dest, 0, format_commit(dest, fmt, NULL, args, SSTR_DEFAULT_POLICY));
+}
+
+int sstr_format_unchecked(SStr *dest, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = sstr_vformat_unchecked(dest, fmt, args);
+    va_end(args);
+    return result;
+}
+#endif /* SSTR_ENABLE_FORMAT */
+
+/* Counts one event for a group, as in sstr.c */
+#if SSTR_ENABLE_STATS
+#define SSTR_STAT(api, event, dest, bytes)                                                         \
+    sstr_stats_record(SSTR_STATS_##api, SSTR_STATS_##event, dest, bytes)
+#else
+#define SSTR_STAT(api, event, dest, bytes) ((void)0)
+#endif
+
+/* 10^n for n >= 1; entry 0 is 0 so that zero counts as one digit */
+static const uint64_t sstr_pow10[20] = {0ULL,
+                                        10ULL,
+                                        100ULL,
+                                        1000ULL,
+                                        10000ULL,
+                                        100000ULL,
+                                        1000000ULL,
+                                        10000000ULL,
+                                        100000000ULL,
+                                        1000000000ULL,
+                                        10000000000ULL,
+                                        100000000000ULL,
+                                        1000000000000ULL,
+                                        10000000000000ULL,
+                                        100000000000000ULL,
+                                        1000000000000000ULL,
+                                        10000000000000000ULL,
+                                        100000000000000000ULL,
+                                        1000000000000000000ULL,
+                                        10000000000000000000ULL};
+
+/* Number of significant bits in value, at least 1 */
+static size_t integer_bits(uint64_t value)
+{
+#if defined(__GNUC__)
+    return (size_t)(64 - __builtin_clzll((unsigned long long)(value | 1)));
+#else
+    size_t bits = 1;
+    while ((value >>= 1) != 0) {
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+static size_t decimal_length(uint64_t value)
+{
+    /* bits * log10(2) underestimates the digit count by at most one */
+    size_t t = (integer_bits(value) * 1233) >> 12;
+    return t + (value >= sstr_pow10[t]);
+}
+
+static size_t hex_length(uint64_t value)
+{
+    return (integer_bits(value) + 3) / 4;
+}
+
+#if SSTR_ENABLE_GROWABLE
+/* Grow dest to take pad plus len more characters, checking pad on its own
+ * so that a huge min_width cannot wrap the sum */
+static int append_integer_grow(SStr *dest, size_t pad, size_t len)
+{
+    size_t room = SSTR_CAPACITY_MAX - dest->length;
+    return pad <= room && len <= room - pad &&
+           sstr_reserve(dest, dest->length + pad + len) == SSTR_SUCCESS;
+}
+#endif
+
+/* Append an optional sign, pad zeros and the digits of value, in decimal
+ * unless hex_digits is given. The common case writes straight into the
+ * free space; only truncation goes through a bounded output window. */
+static SStrResult append_integer(SStr *dest, int negative, uint64_t value, size_t min_width,
+                                 const char *hex_digits, SStrTruncationPolicy policy)
+{
+    if (dest == NULL || dest->data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    size_t digit_len = hex_digits != NULL ? hex_length(value) : decimal_length(value);
+    size_t pad = min_width > digit_len ? min_width - digit_len : 0;
+    size_t sign_len = negative ? 1 : 0;
+    size_t available = dest->capacity - dest->length;
+    char *out = dest->data + dest->length;
+    int fits = pad <= available && sign_len + pad + digit_len <= available;
+
+#if SSTR_ENABLE_GROWABLE
+    if (!fits && dest->allocator != NULL &&
+        append_integer_grow(dest, pad, sign_len + digit_len)) {
+        available = dest->capacity - dest->length;
+        out = dest->data + dest->length;
+        fits = 1;
+    }
+#endif
+
+    if (!fits) {
+        if (policy == SSTR_ERROR) {
+            SSTR_STAT(APPEND, OVERFLOW, dest, 0);
+            return SSTR_ERROR_OVERFLOW;
+        }
+        SSTR_STAT(APPEND, TRUNCATION, dest, 0);
+
+        char digits[SSTR_INT_DIGITS_MAX];
+        char *end = digits + sizeof(digits);
+        char *start = hex_digits != NULL ? format_hex(end, value, hex_digits)
+                                         : format_decimal(end, value);
+        SStrFormatOut window = {out, available, 0, NULL, SSTR_SUCCESS};
+
+        format_put(&window, "-", sign_len);
+        format_pad(&window, '0', pad);
+        format_put(&window, start, digit_len);
+
+        dest->length = dest->capacity;
+        dest->data[dest->length] = '\0';
+        SSTR_STAT(APPEND, WRITE, dest, available);
+        return SSTR_SUCCESS;
+    }
+
+    if (negative) {
+        *out++ = '-';
+    }
+    memset(out, '0', pad);
+    out += pad + digit_len;
+    if (hex_digits != NULL) {
+        format_hex(out, value, hex_digits);
+    } else {
+        format_decimal(out, value);
+    }
+
+    dest->length = (size_t)(out - dest->data);
+    *out = '\0';
+    SSTR_STAT(APPEND, WRITE, dest, sign_len + pad + digit_len);
+
+    return SSTR_SUCCESS;
+}
+
+static inline SStrResult append_i64_impl(SStr *dest, int64_t value, SStrTruncationPolicy policy)
+{
+    /* Negate in unsigned arithmetic so INT64_MIN has a magnitude */
+    uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    return append_integer(dest, value < 0, magnitude, 0, NULL, policy);
+}
+
+static inline SStrResult append_hex_impl(SStr *dest, uint64_t value, size_t min_width,
+                                         int uppercase, SStrTruncationPolicy policy)
+{
+    return append_integer(dest, 0, value, min_width, uppercase ? sstr_hex_upper : sstr_hex_lower,
+                          policy);
+}
+
+SStrResult sstr_append_i64(SStr *dest, int64_t value)
+{
+    return append_i64_impl(dest, value, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_u64(SStr *dest, uint64_t value)
+{
+    return append_integer(dest, 0, value, 0, NULL, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_hex(SStr *dest, uint64_t value, size_t min_width, int uppercase)
+{
+    return append_hex_impl(dest, value, min_width, uppercase, SSTR_DEFAULT_POLICY);
+}
+
+SStrResult sstr_append_i64_ex(SStr *dest, int64_t value, SStrTruncationPolicy policy)
+{
+    if (policy != SSTR_ERROR && policy != SSTR_TRUNCATE) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return append_i64_impl(dest, value, policy);
+}
+
+SStrResult sstr_append_u64_ex(SStr *dest, uint64_t value, SStrTruncationPolicy policy)
+{
+    if (policy != SSTR_ERROR && policy != SSTR_TRUNCATE) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return append_integer(dest, 0, value, 0, NULL, policy);
+}
+
+SStrResult sstr_append_hex_ex(SStr *dest, uint64_t value, size_t min_width, int uppercase,
+                              SStrTruncationPolicy policy)
+{
+    if (policy != SSTR_ERROR && policy != SSTR_TRUNCATE) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    return append_hex_impl(dest, value, min_width, uppercase, policy);
+}
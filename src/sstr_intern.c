@@ -0,0 +1,138 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/cbmc_stubs.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Returns the slot holding s, or the free slot ending its probe sequence.
+ * The index always has a free slot, so the probe terminates. */
+static SStrInternSlot *sstr_intern_probe(const SStrInternTable *table, SStrView s,
+                                         uint32_t hash)
+{
+    size_t i = hash & table->slot_mask;
+
+    for (;;) {
+        SStrInternSlot *slot = &table->slots[i];
+        if (slot->length == SSTR_INTERN_EMPTY) {
+            return slot;
+        }
+        if (slot->hash == hash && slot->length == s.length &&
+            (s.length == 0 || memcmp(table->pool + slot->offset, s.data, s.length) == 0)) {
+            return slot;
+        }
+        i = (i + 1) & table->slot_mask;
+    }
+}
+
+static SStrView sstr_intern_view(const SStrInternTable *table, const SStrInternSlot *slot)
+{
+    SStrView view;
+    view.data = table->pool + slot->offset;
+    view.length = slot->length;
+    return view;
+}
+
+SStrResult sstr_intern_init(SStrInternTable *table, SStrInternSlot *slots, size_t slot_count,
+                            char *pool, size_t pool_size)
+{
+    return sstr_intern_init_seed(table, slots, slot_count, pool, pool_size, 0);
+}
+
+SStrResult sstr_intern_init_seed(SStrInternTable *table, SStrInternSlot *slots,
+                                 size_t slot_count, char *pool, size_t pool_size, uint64_t seed)
+{
+    if (table == NULL || slots == NULL || pool == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+        return SSTR_ERROR_ARGUMENT;
+    }
+
+    table->slots = slots;
+    table->slot_mask = slot_count - 1;
+    table->limit = slot_count - (slot_count + 3) / 4;
+    table->pool = pool;
+    table->pool_size = pool_size < UINT32_MAX ? pool_size : UINT32_MAX;
+    table->seed = seed;
+
+    return sstr_intern_reset(table);
+}
+
+SStrResult sstr_intern(SStrInternTable *table, SStrView s, SStrView *out)
+{
+    if (table == NULL || table->slots == NULL || s.data == NULL || out == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    uint32_t hash = (uint32_t)sstr_view_hash_seed(s, table->seed);
+    SStrInternSlot *slot = sstr_intern_probe(table, s, hash);
+
+    if (slot->length == SSTR_INTERN_EMPTY) {
+        /* Written so that s.length + 1 cannot wrap */
+        if (table->count >= table->limit || s.length >= table->pool_size - table->pool_used) {
+            return SSTR_ERROR_OVERFLOW;
+        }
+
+        char *copy = table->pool + table->pool_used;
+        if (s.length > 0) {
+            memcpy(copy, s.data, s.length);
+        }
+        copy[s.length] = '\0';
+
+        slot->hash = hash;
+        slot->offset = (uint32_t)table->pool_used;
+        slot->length = (uint32_t)s.length;
+        table->pool_used += s.length + 1;
+        table->count++;
+
+        __CPROVER_assert(table->pool_used <= table->pool_size, "Copy stays within the pool");
+    }
+
+    *out = sstr_intern_view(table, slot);
+
+    return SSTR_SUCCESS;
+}
+
+int sstr_intern_find(const SStrInternTable *table, SStrView s, SStrView *out)
+{
+    if (table == NULL || table->slots == NULL || s.data == NULL || out == NULL) {
+        return 0;
+    }
+
+    uint32_t hash = (uint32_t)sstr_view_hash_seed(s, table->seed);
+    SStrInternSlot *slot = sstr_intern_probe(table, s, hash);
+    if (slot->length == SSTR_INTERN_EMPTY) {
+        return 0;
+    }
+
+    *out = sstr_intern_view(table, slot);
+
+    return 1;
+}
+
+SStrResult sstr_intern_reset(SStrInternTable *table)
+{
+    if (table == NULL || table->slots == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    for (size_t i = 0; i <= table->slot_mask; i++) {
+        table->slots[i].length = SSTR_INTERN_EMPTY;
+    }
+    table->count = 0;
+    table->pool_used = 0;
+
+    return SSTR_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Eight bytes as a little-endian word, so the first character is the low
+ * byte on every platform */
+static inline uint64_t sstr_parse_load8(const unsigned char *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+           (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 |
+           (uint64_t)p[7] << 56;
+}
+
+/* Nonzero when all eight bytes are '0' to '9': each byte must have high
+ * nibble 3, and still have it after adding 6 to the low nibble */
+static inline int sstr_parse_all_digits8(uint64_t word)
+{
+    return (word & UINT64_C(0xf0f0f0f0f0f0f0f0)) == UINT64_C(0x3030303030303030) &&
+           ((word + UINT64_C(0x0606060606060606)) & UINT64_C(0xf0f0f0f0f0f0f0f0)) ==
+               UINT64_C(0x3030303030303030);
+}
+
+/* The value of eight digits loaded by sstr_parse_load8, combining
+ * neighbouring digits, then pairs, then quads */
+static inline uint64_t sstr_parse_digits8(uint64_t word)
+{
+    word &= UINT64_C(0x0f0f0f0f0f0f0f0f);
+    word = (word * 10 + (word >> 8)) & UINT64_C(0x00ff00ff00ff00ff);
+    word = (word * 100 + (word >> 16)) & UINT64_C(0x0000ffff0000ffff);
+    return (word * 10000 + (word >> 32)) & UINT64_C(0x00000000ffffffff);
+}
+
+/* Parses the decimal digits of data[0, len) up to limit. Returns the
+ * number of digits; *overflow is set if the value exceeds limit. */
+static size_t sstr_parse_decimal(const unsigned char *data, size_t len, uint64_t limit,
+                                 uint64_t *value, int *overflow)
+{
+    uint64_t v = 0;
+    size_t i = 0;
+
+    *overflow = 0;
+
+    while (len - i >= 8) {
+        uint64_t word = sstr_parse_load8(data + i);
+        if (!sstr_parse_all_digits8(word)) {
+            break;
+        }
+        uint64_t chunk = sstr_parse_digits8(word);
+        if (v > (limit - chunk) / 100000000u) {
+            *overflow = 1;
+        } else {
+            v = v * 100000000u + chunk;
+        }
+        i += 8;
+    }
+
+    for (; i < len && data[i] >= '0' && data[i] <= '9'; i++) {
+        unsigned digit = (unsigned)(data[i] - '0');
+        if (v > (limit - digit) / 10) {
+            *overflow = 1;
+        } else {
+            v = v * 10 + digit;
+        }
+    }
+
+    *value = v;
+    return i;
+}
+
+/* Shared tail of the parsers: reports the outcome once the digits of
+ * src[start, end) have been read */
+static SStrResult sstr_parse_finish(SStrView src, size_t start, size_t end, int overflow,
+                                    size_t *consumed)
+{
+    if (end == start) {
+        if (consumed != NULL) {
+            *consumed = 0;
+        }
+        return SSTR_ERROR_FORMAT;
+    }
+
+    if (consumed != NULL) {
+        *consumed = end;
+    } else if (end != src.length) {
+        return SSTR_ERROR_FORMAT;
+    }
+
+    return overflow ? SSTR_ERROR_OVERFLOW : SSTR_SUCCESS;
+}
+
+SStrResult sstr_parse_i64(SStrView src, int64_t *out, size_t *consumed)
+{
+    if (src.data == NULL || out == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    const unsigned char *p = (const unsigned char *)src.data;
+    size_t start = 0;
+    int negative = 0;
+
+    if (src.length > 0 && (p[0] == '+' || p[0] == '-')) {
+        negative = p[0] == '-';
+        start = 1;
+    }
+
+    /* The magnitude of INT64_MIN is one more than INT64_MAX */
+    uint64_t limit = (uint64_t)INT64_MAX + (uint64_t)negative;
+    uint64_t magnitude;
+    int overflow;
+    size_t digits = sstr_parse_decimal(p + start, src.length - start, limit, &magnitude, &overflow);
+
+    SStrResult result = sstr_parse_finish(src, start, start + digits, overflow, consumed);
+    if (result == SSTR_SUCCESS) {
+        /* The magnitude of INT64_MIN has no positive int64_t to negate */
+        if (!negative) {
+            *out = (int64_t)magnitude;
+        } else if (magnitude > (uint64_t)INT64_MAX) {
+            *out = INT64_MIN;
+        } else {
+            *out = -(int64_t)magnitude;
+        }
+    }
+
+    return result;
+}
+
+SStrResult sstr_parse_u64(SStrView src, uint64_t *out, size_t *consumed)
+{
+    if (src.data == NULL || out == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    const unsigned char *p = (const unsigned char *)src.data;
+    size_t start = src.length > 0 && p[0] == '+' ? 1 : 0;
+    uint64_t value;
+    int overflow;
+    size_t digits =
+        sstr_parse_decimal(p + start, src.length - start, UINT64_MAX, &value, &overflow);
+
+    SStrResult result = sstr_parse_finish(src, start, start + digits, overflow, consumed);
+    if (result == SSTR_SUCCESS) {
+        *out = value;
+    }
+
+    return result;
+}
+
+/* Value of a hex digit, or 16 for any other byte */
+static inline unsigned sstr_parse_hex_digit(unsigned char c)
+{
+    if (c >= '0' && c <= '9') {
+        return (unsigned)(c - '0');
+    }
+    c = (unsigned char)(c | 0x20); /* ASCII letters to lower case */
+    if (c >= 'a' && c <= 'f') {
+        return (unsigned)(c - 'a' + 10);
+    }
+    return 16;
+}
+
+SStrResult sstr_parse_hex(SStrView src, uint64_t *out, size_t *consumed)
+{
+    if (src.data == NULL || out == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    const unsigned char *p = (const unsigned char *)src.data;
+    size_t start = 0;
+
+    if (src.length > 2 && p[0] == '0' && (p[1] | 0x20) == 'x' && sstr_parse_hex_digit(p[2]) < 16) {
+        start = 2;
+    }
+
+    uint64_t value = 0;
+    int overflow = 0;
+    size_t i = start;
+    for (unsigned digit; i < src.length && (digit = sstr_parse_hex_digit(p[i])) < 16; i++) {
+        if (value >> 60 != 0) {
+            overflow = 1;
+        } else {
+            value = value << 4 | digit;
+        }
+    }
+
+    SStrResult result = sstr_parse_finish(src, start, i, overflow, consumed);
+    if (result == SSTR_SUCCESS) {
+        *out = value;
+    }
+
+    return result;
+}
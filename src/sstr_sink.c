@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/cbmc_stubs.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <string.h>
+
+SStrResult sstr_sink_init(SStrSink *sink, char *buffer, size_t buffer_size, SStrSinkFlush flush,
+                          void *context)
+{
+    if (sink == NULL || buffer == NULL || flush == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    /* A sink needs room for at least one byte between flushes */
+    if (buffer_size < 2) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    SStrResult result = sstr_init(&sink->buffer, buffer, buffer_size);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    sink->flush = flush;
+    sink->context = context;
+    sink->flushed = 0;
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_sink_flush(SStrSink *sink)
+{
+    if (sink == NULL || sink->buffer.data == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (sink->buffer.length == 0) {
+        return SSTR_SUCCESS;
+    }
+
+    SStrResult result = sink->flush(sink->context, sink->buffer.data, sink->buffer.length);
+    if (result != SSTR_SUCCESS) {
+        return result;
+    }
+
+    sink->flushed += sink->buffer.length;
+    sink->buffer.length = 0;
+    sink->buffer.data[0] = '\0';
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_sink_write(SStrSink *sink, const char *data, size_t length)
+{
+    if (sink == NULL || sink->buffer.data == NULL || (data == NULL && length > 0)) {
+        return SSTR_ERROR_NULL;
+    }
+
+    if (length == 0) {
+        return SSTR_SUCCESS;
+    }
+
+    SStr *buffer = &sink->buffer;
+    size_t available = (size_t)buffer->capacity - buffer->length;
+
+    if (length > available) {
+        SStrResult result = sstr_sink_flush(sink);
+        if (result != SSTR_SUCCESS) {
+            return result;
+        }
+
+        /* Copying a write this large would only fill the buffer to flush
+         * it again, so hand it over in place */
+        if (length >= buffer->capacity) {
+            result = sink->flush(sink->context, data, length);
+            if (result == SSTR_SUCCESS) {
+                sink->flushed += length;
+            }
+            return result;
+        }
+    }
+
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+
+    return SSTR_SUCCESS;
+}
+
+SStrResult sstr_sink_append(SStrSink *sink, const char *src)
+{
+    if (src == NULL) {
+        return SSTR_ERROR_NULL;
+    }
+
+    SStrView view = sstr_view_from_cstr(src);
+    if (view.data == NULL) {
+        return SSTR_ERROR_OVERFLOW; /* Longer than SSTR_MAX_SIZE */
+    }
+
+    return sstr_sink_write(sink, view.data, view.length);
+}
+
+SStrResult sstr_sink_append_view(SStrSink *sink, SStrView src)
+{
+    return sstr_sink_write(sink, src.data, src.length);
+}
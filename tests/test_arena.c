@@ -0,0 +1,150 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+static int test_arena_alloc(void)
+{
+    char block[32];
+    SStrArena arena;
+    SStr a;
+    SStr b;
+
+    TEST_ASSERT(sstr_arena_init(&arena, block, sizeof(block)) == SSTR_SUCCESS,
+                "Arena init should succeed");
+    TEST_ASSERT(sstr_arena_available(&arena) == 32, "Whole block should be available");
+
+    /* Allocations are consecutive and initialized like sstr_init */
+    TEST_ASSERT(sstr_arena_alloc(&arena, &a, 9) == SSTR_SUCCESS, "First alloc should succeed");
+    TEST_ASSERT(a.data == block && a.capacity == 9 && a.length == 0 && a.data[0] == '\0',
+                "First string should start the block");
+    TEST_ASSERT(sstr_arena_alloc(&arena, &b, 5) == SSTR_SUCCESS, "Second alloc should succeed");
+    TEST_ASSERT(b.data == block + 10, "Second string should follow the first");
+    TEST_ASSERT(sstr_arena_available(&arena) == 16, "16 bytes should remain");
+
+    /* Strings are independent */
+    sstr_copy(&a, "123456789");
+    sstr_copy(&b, "abcde");
+    TEST_ASSERT(strcmp(a.data, "123456789") == 0, "First string should be intact");
+    TEST_ASSERT(sstr_append(&b, "f") == SSTR_ERROR_OVERFLOW, "Capacity should be enforced");
+
+    /* Exactly filling the block succeeds, one byte more fails */
+    SStr c;
+    TEST_ASSERT(sstr_arena_alloc(&arena, &c, 16) == SSTR_ERROR_OVERFLOW,
+                "Allocation over the free space should fail");
+    TEST_ASSERT(sstr_arena_alloc(&arena, &c, 15) == SSTR_SUCCESS, "Exact fit should succeed");
+    TEST_ASSERT(sstr_arena_available(&arena) == 0, "Arena should be full");
+    TEST_ASSERT(sstr_arena_alloc(&arena, &c, 0) == SSTR_ERROR_OVERFLOW,
+                "Full arena should reject even an empty string");
+    TEST_ASSERT(sstr_arena_alloc(&arena, &c, (size_t)-1) == SSTR_ERROR_OVERFLOW,
+                "Huge capacity should fail");
+
+    /* Reset hands out the block again */
+    TEST_ASSERT(sstr_arena_reset(&arena) == SSTR_SUCCESS, "Reset should succeed");
+    TEST_ASSERT(sstr_arena_available(&arena) == 32, "Reset should free the block");
+    TEST_ASSERT(sstr_arena_alloc(&arena, &a, 31) == SSTR_SUCCESS, "Alloc after reset should work");
+    TEST_ASSERT(a.data == block, "Allocation should restart at the base");
+
+    /* NULL arguments */
+    TEST_ASSERT(sstr_arena_init(NULL, block, sizeof(block)) == SSTR_ERROR_NULL,
+                "NULL arena should fail");
+    TEST_ASSERT(sstr_arena_init(&arena, NULL, 8) == SSTR_ERROR_NULL, "NULL block should fail");
+    TEST_ASSERT(sstr_arena_alloc(&arena, NULL, 1) == SSTR_ERROR_NULL, "NULL string should fail");
+    TEST_ASSERT(sstr_arena_reset(NULL) == SSTR_ERROR_NULL, "NULL reset should fail");
+    TEST_ASSERT(sstr_arena_available(NULL) == 0, "NULL arena has nothing available");
+
+    return 1;
+}
+
+static int test_arena_grow(void)
+{
+    char block[32];
+    SStrArena arena;
+    SStr a;
+    SStr b;
+
+    sstr_arena_init(&arena, block, sizeof(block));
+    sstr_arena_alloc(&arena, &a, 3);
+    sstr_arena_alloc(&arena, &b, 3);
+    sstr_copy(&b, "abc");
+
+    /* The top string grows in place and keeps its content */
+    TEST_ASSERT(sstr_arena_grow(&arena, &b, 10) == SSTR_SUCCESS, "Top string should grow");
+    TEST_ASSERT(b.capacity == 10 && b.data == block + 4, "Growth should be in place");
+    TEST_ASSERT(strcmp(b.data, "abc") == 0 && b.length == 3, "Content should be kept");
+    TEST_ASSERT(sstr_append(&b, "defghij") == SSTR_SUCCESS, "Grown capacity should be usable");
+    TEST_ASSERT(sstr_arena_available(&arena) == 17, "Growth should consume arena space");
+
+    /* Shrinking requests are a no-op */
+    TEST_ASSERT(sstr_arena_grow(&arena, &b, 2) == SSTR_SUCCESS, "Smaller capacity is a no-op");
+    TEST_ASSERT(b.capacity == 10, "Capacity should be unchanged");
+
+    /* Strings below the top cannot grow */
+    TEST_ASSERT(sstr_arena_grow(&arena, &a, 5) == SSTR_ERROR_ARGUMENT,
+                "Non-top string should be rejected");
+
+    /* Strings from elsewhere are rejected */
+    char other_buffer[8];
+    SStr other;
+    sstr_init(&other, other_buffer, sizeof(other_buffer));
+    TEST_ASSERT(sstr_arena_grow(&arena, &other, 9) == SSTR_ERROR_ARGUMENT,
+                "Foreign string should be rejected");
+
+    /* Growth is limited by the free space */
+    TEST_ASSERT(sstr_arena_grow(&arena, &b, 28) == SSTR_ERROR_OVERFLOW,
+                "Growth past the block should fail");
+    TEST_ASSERT(b.capacity == 10, "Failed growth should leave the string unchanged");
+    TEST_ASSERT(sstr_arena_grow(&arena, &b, 27) == SSTR_SUCCESS, "Growth to the end should work");
+    TEST_ASSERT(sstr_arena_available(&arena) == 0, "Arena should be full");
+
+    /* After a reset nothing is at the top */
+    sstr_arena_reset(&arena);
+    TEST_ASSERT(sstr_arena_grow(&arena, &b, 28) == SSTR_ERROR_ARGUMENT,
+                "Strings from before a reset should be rejected");
+
+    TEST_ASSERT(sstr_arena_grow(&arena, NULL, 4) == SSTR_ERROR_NULL, "NULL string should fail");
+
+    return 1;
+}
+
+int run_arena_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running arena tests...\n");
+
+    total++;
+    if (test_arena_alloc()) {
+        passed++;
+        printf("PASS: arena allocation tests\n");
+    }
+
+    total++;
+    if (test_arena_grow()) {
+        passed++;
+        printf("PASS: arena growth tests\n");
+    }
+
+    printf("Arena tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+static int test_chain_build(void)
+{
+    SStrView segments[4];
+    char scratch[32];
+    char payload[SSTR_CHAIN_COPY_MAX + 16];
+    char flat_buffer[256];
+    SStrChain chain;
+    SStr flat;
+
+    memset(payload, 'p', sizeof(payload));
+    SStrView body = {payload, sizeof(payload)};
+
+    TEST_ASSERT(sstr_chain_init(&chain, segments, 4, scratch, sizeof(scratch)) == SSTR_SUCCESS,
+                "Chain init should succeed");
+    sstr_init(&flat, flat_buffer, sizeof(flat_buffer));
+
+    /* Short pieces are copied and share one segment */
+    TEST_ASSERT(sstr_chain_append(&chain, "HTTP/1.1 200 OK\r\n") == SSTR_SUCCESS,
+                "Status line should append");
+    TEST_ASSERT(sstr_chain_append_view(&chain, SSTR_VIEW_LIT("\r\n")) == SSTR_SUCCESS,
+                "Header end should append");
+    TEST_ASSERT(chain.count == 1, "Copied pieces should merge");
+    TEST_ASSERT(segments[0].data == scratch && segments[0].length == 19,
+                "Merged segment should cover the scratch buffer");
+
+    /* Long pieces are referenced in place */
+    TEST_ASSERT(sstr_chain_append_view(&chain, body) == SSTR_SUCCESS, "Body should append");
+    TEST_ASSERT(chain.count == 2 && segments[1].data == payload, "Body should not be copied");
+
+    /* A piece following the last segment in memory extends it */
+    SStrView first = {payload, 8};
+    SStrView rest = {payload + 8, 8};
+    SStrChain tail;
+    SStrView tail_segments[2];
+    char tail_scratch[4];
+    sstr_chain_init(&tail, tail_segments, 2, tail_scratch, sizeof(tail_scratch));
+    TEST_ASSERT(sstr_chain_append_view(&tail, first) == SSTR_SUCCESS &&
+                    sstr_chain_append_view(&tail, rest) == SSTR_SUCCESS,
+                "Adjacent pieces should append");
+    TEST_ASSERT(tail.count == 1 && tail_segments[0].data == payload &&
+                    tail_segments[0].length == 16,
+                "Adjacent pieces should share a segment");
+
+    /* Short pieces fall back to references once the scratch buffer is full */
+    TEST_ASSERT(sstr_chain_append_view(&chain, SSTR_VIEW_LIT("0123456789ab")) == SSTR_SUCCESS,
+                "Short piece should append");
+    TEST_ASSERT(chain.count == 3 && chain.scratch.length == 31, "Piece should be copied");
+    TEST_ASSERT(sstr_chain_append(&chain, "XY") == SSTR_SUCCESS,
+                "Piece past the scratch buffer should append");
+    TEST_ASSERT(chain.count == 4 && chain.scratch.length == 31, "Piece should be referenced");
+    TEST_ASSERT(chain.length == 19 + sizeof(payload) + 14, "Length should cover every piece");
+
+    /* Both the segments and the scratch buffer are full now */
+    TEST_ASSERT(sstr_chain_append_view(&chain, body) == SSTR_ERROR_OVERFLOW,
+                "Full segment array should overflow");
+    TEST_ASSERT(sstr_chain_append_copy(&chain, SSTR_VIEW_LIT("z")) == SSTR_ERROR_OVERFLOW,
+                "Full scratch buffer should overflow");
+    TEST_ASSERT(chain.length == 19 + sizeof(payload) + 14, "Failed appends should not count");
+
+    /* Flattening produces the bytes in order */
+    TEST_ASSERT(sstr_chain_flatten(&chain, &flat) == SSTR_SUCCESS, "Flatten should succeed");
+    TEST_ASSERT(flat.length == chain.length, "Flattened length should match");
+    TEST_ASSERT(memcmp(flat.data, "HTTP/1.1 200 OK\r\n\r\np", 20) == 0 &&
+                    strcmp(flat.data + 19 + sizeof(payload), "0123456789abXY") == 0,
+                "Flattened bytes should be in order");
+
+    char small_buffer[16];
+    SStr small;
+    sstr_init(&small, small_buffer, sizeof(small_buffer));
+    sstr_copy(&small, "keep");
+    TEST_ASSERT(sstr_chain_flatten(&chain, &small) == SSTR_ERROR_OVERFLOW,
+                "Flatten into a small string should overflow");
+    TEST_ASSERT(strcmp(small.data, "keep") == 0 && small.length == 4,
+                "Rejected flatten should leave dest unchanged");
+
+    /* Reset empties the chain for reuse */
+    TEST_ASSERT(sstr_chain_reset(&chain) == SSTR_SUCCESS, "Reset should succeed");
+    TEST_ASSERT(chain.count == 0 && chain.length == 0 && chain.scratch.length == 0,
+                "Reset should empty the chain");
+    TEST_ASSERT(sstr_chain_flatten(&chain, &flat) == SSTR_SUCCESS && flat.length == 0,
+                "Empty chain should flatten to an empty string");
+
+    TEST_ASSERT(sstr_chain_append(NULL, "a") == SSTR_ERROR_NULL, "NULL chain should fail");
+    TEST_ASSERT(sstr_chain_append_sstr(&chain, NULL) == SSTR_ERROR_NULL,
+                "NULL source should fail");
+
+    return 1;
+}
+
+static int test_chain_consume(void)
+{
+    SStrView segments[4];
+    char scratch[16];
+    char payload[100];
+    SStrChain chain;
+
+    memset(payload, 'b', sizeof(payload));
+    SStrView body = {payload, sizeof(payload)};
+
+    sstr_chain_init(&chain, segments, 4, scratch, sizeof(scratch));
+    sstr_chain_append(&chain, "head:");
+    sstr_chain_append_view(&chain, body);
+    sstr_chain_append(&chain, ";");
+
+#if SSTR_ENABLE_IOVEC
+    struct iovec iov[4];
+    TEST_ASSERT(sstr_chain_iov(&chain, iov, 4) == 3, "Every segment should be described");
+    TEST_ASSERT(iov[0].iov_base == (void *)scratch && iov[0].iov_len == 5,
+                "First entry should be the copied header");
+    TEST_ASSERT(iov[1].iov_base == (void *)payload && iov[1].iov_len == 100,
+                "Second entry should reference the payload");
+    TEST_ASSERT(sstr_chain_iov(&chain, iov, 2) == 2, "A short iov array should be filled");
+#endif
+
+    /* A short write ends inside the payload */
+    TEST_ASSERT(sstr_chain_consume(&chain, 55) == SSTR_SUCCESS, "Consume should succeed");
+    TEST_ASSERT(chain.length == 51 && chain.first == 1, "The header should be consumed");
+    TEST_ASSERT(segments[1].data == payload + 50 && segments[1].length == 50,
+                "The payload should be trimmed");
+
+#if SSTR_ENABLE_IOVEC
+    TEST_ASSERT(sstr_chain_iov(&chain, iov, 4) == 2 && iov[0].iov_base == (void *)(payload + 50),
+                "The iov should resume mid-payload");
+#endif
+
+    TEST_ASSERT(sstr_chain_consume(&chain, 52) == SSTR_ERROR_ARGUMENT,
+                "Consuming past the end should fail");
+    TEST_ASSERT(sstr_chain_consume(&chain, 51) == SSTR_SUCCESS, "Consume rest should succeed");
+    TEST_ASSERT(chain.count == 0 && chain.length == 0 && chain.scratch.length == 0,
+                "A consumed chain should be empty again");
+    TEST_ASSERT(sstr_chain_consume(&chain, 0) == SSTR_SUCCESS, "Empty consume should succeed");
+
+    return 1;
+}
+
+int run_chain_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running chain tests...\n");
+
+    total++;
+    if (test_chain_build()) {
+        passed++;
+        printf("PASS: chain build tests\n");
+    }
+
+    total++;
+    if (test_chain_consume()) {
+        passed++;
+        printf("PASS: chain consume tests\n");
+    }
+
+    printf("Chain tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -8,10 +8,17 @@
  * SPDX-License-Identifier: MPL-2.0
  */
 
+#define _DEFAULT_SOURCE
+
 #include "../include/sstr/sstr.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #define TEST_ASSERT(condition, message)                                                            \
     do {                                                                                           \
@@ -205,6 +212,977 @@ static int test_append_sstr(void)
     return 1;
 }
 
+static int test_copy_scan(void)
+{
+    /* Exercise the terminator scan at every alignment and around block sizes */
+    char source[160];
+    char buffer[128];
+    SStr str;
+
+    for (size_t offset = 0; offset < 32; offset++) {
+        for (size_t len = 0; len < 100; len++) {
+            memset(source, 'a', sizeof(source));
+            source[offset + len] = '\0';
+            const char *src = source + offset;
+
+            size_t sizes[] = {len, len + 1, len + 2, len + 33};
+            for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+                if (sizes[k] == 0 || sizes[k] > sizeof(buffer)) {
+                    continue;
+                }
+                sstr_init(&str, buffer, sizes[k]);
+                sstr_copy(&str, &"previous"[8 - (str.capacity < 8 ? str.capacity : 8)]);
+                SStr before = str;
+                SStrResult result = sstr_copy(&str, src);
+                if (len <= str.capacity) {
+                    TEST_ASSERT(result == SSTR_SUCCESS, "Copy should succeed");
+                    TEST_ASSERT(str.length == len, "Length should match the source");
+                    TEST_ASSERT(memcmp(str.data, src, len + 1) == 0, "Content should match");
+                } else if (SSTR_DEFAULT_POLICY == SSTR_ERROR) {
+                    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+                    TEST_ASSERT(str.length == before.length, "Length should be unchanged");
+                    TEST_ASSERT(strcmp(str.data, &"previous"[8 - before.length]) == 0,
+                                "Content should be unchanged after overflow");
+                } else {
+                    TEST_ASSERT(str.length == str.capacity, "Should truncate to capacity");
+                }
+
+                /* Append scans the same way from an unaligned tail */
+                sstr_init(&str, buffer, sizes[k]);
+                sstr_copy(&str, "x");
+                result = sstr_append(&str, src);
+                if (len + 1 <= str.capacity) {
+                    TEST_ASSERT(result == SSTR_SUCCESS, "Append should succeed");
+                    TEST_ASSERT(str.length == len + 1, "Length should include the prefix");
+                    TEST_ASSERT(memcmp(str.data + 1, src, len + 1) == 0, "Content should match");
+                } else if (SSTR_DEFAULT_POLICY == SSTR_ERROR && str.length == 1) {
+                    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+                    TEST_ASSERT(strcmp(str.data, "x") == 0,
+                                "Content should be unchanged after overflow");
+                } else if (SSTR_DEFAULT_POLICY != SSTR_ERROR) {
+                    TEST_ASSERT(str.length == str.capacity, "Should truncate to capacity");
+                    TEST_ASSERT(str.data[str.length] == '\0', "Should stay terminated");
+                }
+            }
+        }
+    }
+
+    /* A source inside the destination is measured before it is copied */
+    char self_buffer[64];
+    sstr_init(&str, self_buffer, sizeof(self_buffer));
+    sstr_copy(&str, "abcdefghij");
+    TEST_ASSERT(sstr_append_ex(&str, str.data, SSTR_ERROR) == SSTR_SUCCESS,
+                "Self append should succeed");
+    TEST_ASSERT(strcmp(str.data, "abcdefghijabcdefghij") == 0, "Self append incorrect");
+    TEST_ASSERT(sstr_append_ex(&str, str.data + 14, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Self append from an offset should succeed");
+    TEST_ASSERT(strcmp(str.data, "abcdefghijabcdefghijefghij") == 0,
+                "Self append from an offset incorrect");
+
+    sstr_copy(&str, "0123456789012345678901234567890123456789");
+    TEST_ASSERT(sstr_append_ex(&str, str.data, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Self append past capacity should overflow");
+    TEST_ASSERT(str.length == 40 && strcmp(str.data + 30, "0123456789") == 0,
+                "Content should be unchanged after overflow");
+    TEST_ASSERT(sstr_append_ex(&str, str.data + 30, SSTR_ERROR) == SSTR_SUCCESS,
+                "Self append from an offset should succeed");
+    TEST_ASSERT(sstr_append_ex(&str, str.data, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Self append should truncate");
+    TEST_ASSERT(str.length == str.capacity && memcmp(str.data + 50, "0123456789012", 13) == 0 &&
+                    str.data[str.length] == '\0',
+                "Self append should truncate to the original prefix");
+
+    return 1;
+}
+
+#ifdef MAP_ANONYMOUS
+static int test_scan_guard_page(void)
+{
+    /* Strings ending just before an inaccessible page are scanned without
+     * touching it, whatever their length and alignment */
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *map = (char *)mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                             -1, 0);
+    TEST_ASSERT(map != MAP_FAILED, "Mapping should succeed");
+    TEST_ASSERT(mprotect(map + page, page, PROT_NONE) == 0, "Guard page should be set");
+
+    static char buffer[8192];
+    SStr str;
+    for (size_t len = 0; len < 300; len++) {
+        char *src = map + page - 1 - len;
+        memset(src, 'a', len);
+        src[len] = '\0';
+
+        sstr_init(&str, buffer, sizeof(buffer));
+        TEST_ASSERT(sstr_copy(&str, src) == SSTR_SUCCESS && str.length == len,
+                    "Copy should stop at the terminator");
+        TEST_ASSERT(sstr_append(&str, src) == SSTR_SUCCESS && str.length == 2 * len,
+                    "Append should stop at the terminator");
+        TEST_ASSERT(sstr_view_from_cstr(src).length == len, "View should stop at the terminator");
+        TEST_ASSERT(SSTR_CONCAT(&str, src, src) == SSTR_SUCCESS && str.length == 4 * len,
+                    "Concat should stop at the terminator");
+    }
+
+    munmap(map, 2 * page);
+    return 1;
+}
+#endif
+
+static int test_case_convert(void)
+{
+    char buffer[320];
+    char expected[320];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    sstr_copy(&str, "Content-Type: Text/HTML");
+    TEST_ASSERT(sstr_to_lower(&str) == SSTR_SUCCESS, "Lower should succeed");
+    TEST_ASSERT(strcmp(str.data, "content-type: text/html") == 0, "Lower result incorrect");
+    TEST_ASSERT(sstr_to_upper(&str) == SSTR_SUCCESS, "Upper should succeed");
+    TEST_ASSERT(strcmp(str.data, "CONTENT-TYPE: TEXT/HTML") == 0, "Upper result incorrect");
+    TEST_ASSERT(str.length == 23, "Length should be unchanged");
+
+    /* Every byte value at every block position: only ASCII letters change */
+    for (size_t offset = 0; offset < 40; offset++) {
+        size_t len = 256 + offset % 7;
+        for (size_t i = 0; i < len; i++) {
+            buffer[i] = (char)(i + offset);
+        }
+        buffer[len] = '\0';
+        str.data = buffer;
+        str.length = len;
+
+        for (int upper = 0; upper <= 1; upper++) {
+            for (size_t i = 0; i < len; i++) {
+                unsigned char c = (unsigned char)buffer[i];
+                if (!upper && c >= 'A' && c <= 'Z') {
+                    c = (unsigned char)(c + 32);
+                } else if (upper && c >= 'a' && c <= 'z') {
+                    c = (unsigned char)(c - 32);
+                }
+                expected[i] = (char)c;
+            }
+            TEST_ASSERT((upper ? sstr_to_upper(&str) : sstr_to_lower(&str)) == SSTR_SUCCESS,
+                        "Conversion should succeed");
+            TEST_ASSERT(memcmp(buffer, expected, len) == 0, "Conversion should match reference");
+            TEST_ASSERT(buffer[len] == '\0', "Terminator should be kept");
+        }
+    }
+
+    /* Only the first length bytes are converted */
+    sstr_init(&str, buffer, sizeof(buffer));
+    sstr_copy(&str, "ABC");
+    buffer[4] = 'Z';
+    sstr_to_lower(&str);
+    TEST_ASSERT(buffer[4] == 'Z', "Bytes past the length should be untouched");
+
+    TEST_ASSERT(sstr_to_lower(NULL) == SSTR_ERROR_NULL, "Should detect NULL string");
+    TEST_ASSERT(sstr_to_upper(NULL) == SSTR_ERROR_NULL, "Should detect NULL string");
+
+    return 1;
+}
+
+static int test_trim(void)
+{
+    char buffer[32];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    sstr_copy(&str, " \t key: value \r\n");
+    TEST_ASSERT(sstr_trim(&str) == SSTR_SUCCESS, "Trim should succeed");
+    TEST_ASSERT(str.length == 10 && strcmp(str.data, "key: value") == 0, "Trim result incorrect");
+
+    sstr_copy(&str, "\v\f x ");
+    TEST_ASSERT(sstr_trim_left(&str) == SSTR_SUCCESS, "Trim left should succeed");
+    TEST_ASSERT(str.length == 2 && strcmp(str.data, "x ") == 0, "Trim left result incorrect");
+    TEST_ASSERT(sstr_trim_right(&str) == SSTR_SUCCESS, "Trim right should succeed");
+    TEST_ASSERT(str.length == 1 && strcmp(str.data, "x") == 0, "Trim right result incorrect");
+
+    /* All whitespace trims to empty, and nothing to trim is a no-op */
+    sstr_copy(&str, " \n\t ");
+    TEST_ASSERT(sstr_trim(&str) == SSTR_SUCCESS && str.length == 0 && str.data[0] == '\0',
+                "Whitespace only should trim to empty");
+    TEST_ASSERT(sstr_trim(&str) == SSTR_SUCCESS && str.length == 0, "Empty should stay empty");
+    sstr_copy(&str, "a b");
+    TEST_ASSERT(sstr_trim(&str) == SSTR_SUCCESS && strcmp(str.data, "a b") == 0,
+                "Interior whitespace should be kept");
+
+    /* NUL and non-ASCII bytes are not whitespace */
+    sstr_copy_n(&str, " \0 ", 3);
+    sstr_trim(&str);
+    TEST_ASSERT(str.length == 1 && str.data[0] == '\0', "NUL should not be trimmed");
+    sstr_copy(&str, "\xa0x\x85");
+    sstr_trim(&str);
+    TEST_ASSERT(str.length == 3, "Non-ASCII bytes should not be trimmed");
+
+    TEST_ASSERT(sstr_trim(NULL) == SSTR_ERROR_NULL, "Should detect NULL string");
+    TEST_ASSERT(sstr_trim_left(NULL) == SSTR_ERROR_NULL, "Should detect NULL string");
+    TEST_ASSERT(sstr_trim_right(NULL) == SSTR_ERROR_NULL, "Should detect NULL string");
+
+    return 1;
+}
+
+static int test_view(void)
+{
+    char buffer[16];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* Literal views know their length at compile time */
+    SStrView hello = SSTR_VIEW_LIT("hello");
+    TEST_ASSERT(hello.length == 5, "Literal view length incorrect");
+    TEST_ASSERT(SSTR_VIEW_LIT("").length == 0, "Empty literal view should be empty");
+
+    SStrView world = sstr_view_from_cstr(" world");
+    TEST_ASSERT(world.length == 6, "C string view length incorrect");
+    TEST_ASSERT(sstr_view_from_cstr(NULL).data == NULL, "NULL string should give an empty view");
+
+    /* Copy and append from views */
+    TEST_ASSERT(sstr_copy_view(&str, hello) == SSTR_SUCCESS, "View copy should succeed");
+    TEST_ASSERT(sstr_append_view(&str, world) == SSTR_SUCCESS, "View append should succeed");
+    TEST_ASSERT(str.length == 11 && strcmp(str.data, "hello world") == 0,
+                "View append result incorrect");
+
+    /* Views need not be terminated */
+    SStrView part = {"abcdef", 3};
+    TEST_ASSERT(sstr_copy_view(&str, part) == SSTR_SUCCESS, "Partial view copy should succeed");
+    TEST_ASSERT(strcmp(str.data, "abc") == 0, "Partial view copy incorrect");
+
+    /* A view of the destination itself */
+    sstr_copy(&str, "0123456789");
+    SStrView tail = {str.data + 4, 6};
+    TEST_ASSERT(sstr_copy_view(&str, tail) == SSTR_SUCCESS, "Self view copy should succeed");
+    TEST_ASSERT(strcmp(str.data, "456789") == 0, "Self view copy incorrect");
+    TEST_ASSERT(sstr_append_view(&str, sstr_view_from_sstr(&str)) == SSTR_SUCCESS,
+                "Self view append should succeed");
+    TEST_ASSERT(strcmp(str.data, "456789456789") == 0, "Self view append incorrect");
+
+    /* Overflow leaves the destination unchanged under the error policy */
+    SStrView big = SSTR_VIEW_LIT("this view is far too long");
+    SStrResult result = sstr_append_view(&str, big);
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(strcmp(str.data, "456789456789") == 0, "Content should be unchanged");
+    TEST_ASSERT(sstr_copy_view(&str, big) == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+#else
+    TEST_ASSERT(result == SSTR_SUCCESS && str.length == str.capacity, "Should truncate");
+#endif
+
+    /* Comparison */
+    TEST_ASSERT(sstr_view_equals(SSTR_VIEW_LIT("abc"), part), "Equal views should match");
+    TEST_ASSERT(!sstr_view_equals(SSTR_VIEW_LIT("abd"), part), "Different views should not match");
+    TEST_ASSERT(sstr_view_compare(SSTR_VIEW_LIT("abc"), part) == 0, "Compare should be zero");
+    TEST_ASSERT(sstr_view_compare(SSTR_VIEW_LIT("ab"), part) < 0, "Prefix should sort first");
+    TEST_ASSERT(sstr_view_compare(SSTR_VIEW_LIT("b"), part) > 0, "Compare order incorrect");
+    TEST_ASSERT(sstr_view_compare(SSTR_VIEW_LIT("\xff"), SSTR_VIEW_LIT("a")) > 0,
+                "Compare should use unsigned characters");
+
+    /* NULL handling */
+    TEST_ASSERT(sstr_copy_view(NULL, hello) == SSTR_ERROR_NULL, "Should detect NULL destination");
+    TEST_ASSERT(sstr_append_view(&str, sstr_view_from_cstr(NULL)) == SSTR_ERROR_NULL,
+                "Should detect NULL view");
+
+    return 1;
+}
+
+static int test_compare(void)
+{
+    char buf_a[16], buf_b[16];
+    SStr a, b;
+    sstr_init(&a, buf_a, sizeof(buf_a));
+    sstr_init(&b, buf_b, sizeof(buf_b));
+
+    sstr_copy(&a, "Content-Type");
+    sstr_copy(&b, "Content-Type");
+    TEST_ASSERT(sstr_equals(&a, &b) && sstr_compare(&a, &b) == 0, "Equal strings should match");
+    sstr_copy(&b, "content-type");
+    TEST_ASSERT(!sstr_equals(&a, &b) && sstr_compare(&a, &b) < 0,
+                "Case should matter by default");
+    TEST_ASSERT(sstr_equals_icase(&a, &b) && sstr_compare_icase(&a, &b) == 0,
+                "Case should be ignored by the icase variants");
+    sstr_copy(&b, "Content-Length");
+    TEST_ASSERT(sstr_compare_icase(&a, &b) > 0 && sstr_compare_icase(&b, &a) < 0,
+                "Icase compare order incorrect");
+    sstr_copy(&b, "CONTENT");
+    TEST_ASSERT(sstr_compare_icase(&b, &a) < 0, "Icase prefix should sort first");
+    TEST_ASSERT(!sstr_equals_icase(&a, &b), "Different lengths should not match");
+
+    /* Only ASCII letters fold, and bytes past them compare unsigned */
+    TEST_ASSERT(sstr_view_equals_icase(SSTR_VIEW_LIT("[@]"), SSTR_VIEW_LIT("[@]")),
+                "Punctuation should match itself");
+    TEST_ASSERT(!sstr_view_equals_icase(SSTR_VIEW_LIT("@["), SSTR_VIEW_LIT("`{")),
+                "Bytes next to the letters should not fold");
+    TEST_ASSERT(!sstr_view_equals_icase(SSTR_VIEW_LIT("\xc9"), SSTR_VIEW_LIT("\xe9")),
+                "Non-ASCII bytes should not fold");
+    TEST_ASSERT(sstr_view_compare_icase(SSTR_VIEW_LIT("\xff"), SSTR_VIEW_LIT("a")) > 0,
+                "Icase compare should use unsigned characters");
+
+    /* Lengths are used, so embedded NUL bytes take part */
+    sstr_copy_n(&a, "ab\0c", 4);
+    sstr_copy_n(&b, "ab\0d", 4);
+    TEST_ASSERT(!sstr_equals(&a, &b) && sstr_compare(&a, &b) < 0,
+                "Content after NUL should be compared");
+
+    /* NULL compares as empty */
+    sstr_clear(&a);
+    TEST_ASSERT(sstr_equals(NULL, &a) && sstr_compare(&b, NULL) > 0,
+                "NULL should compare as empty");
+
+    return 1;
+}
+
+static int test_hash(void)
+{
+    char buf_a[80], buf_b[80];
+    SStr a, b;
+    sstr_init(&a, buf_a, sizeof(buf_a));
+    sstr_init(&b, buf_b, sizeof(buf_b));
+
+    /* Equal content hashes equally, wherever it is stored */
+    sstr_copy(&a, "sensor/temperature/3");
+    sstr_copy(&b, "sensor/temperature/3");
+    TEST_ASSERT(sstr_hash(&a) == sstr_hash(&b), "Equal strings should hash equally");
+    TEST_ASSERT(sstr_hash(&a) == sstr_view_hash(sstr_view_from_sstr(&a)),
+                "SStr and view hashes should agree");
+    TEST_ASSERT(sstr_view_hash_seed(sstr_view_from_sstr(&a), 1) != sstr_hash(&a),
+                "Seed should change the hash");
+    TEST_ASSERT(sstr_hash(NULL) == sstr_view_hash(SSTR_VIEW_LIT("")),
+                "NULL should hash as empty");
+
+    /* Every prefix length and single-byte change gives a distinct hash */
+    static uint64_t hashes[160];
+    size_t count = 0;
+    for (size_t i = 0; i < sizeof(buf_a) - 1; i++) {
+        buf_a[i] = (char)('a' + i % 26);
+    }
+    for (size_t n = 0; n < sizeof(buf_a); n++) {
+        char *exact = malloc(n + 1); /* Sized so the sanitizers catch overreads */
+        TEST_ASSERT(exact != NULL, "Allocation should succeed");
+        memcpy(exact, buf_a, n);
+        SStrView v = {exact, n};
+        hashes[count++] = sstr_view_hash(v);
+        if (n > 0) {
+            exact[n / 2] ^= 1;
+            hashes[count++] = sstr_view_hash(v);
+        }
+        free(exact);
+    }
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            TEST_ASSERT(hashes[i] != hashes[j], "Hashes should not collide");
+        }
+    }
+
+    return 1;
+}
+
+static int test_append_many(void)
+{
+    char buffer[16];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+    sstr_copy(&str, ">");
+
+    SStrView parts[] = {SSTR_VIEW_LIT("GET "), SSTR_VIEW_LIT("/a"), SSTR_VIEW_LIT(" ok")};
+    TEST_ASSERT(sstr_append_many(&str, parts, 3) == SSTR_SUCCESS, "Batch append should succeed");
+    TEST_ASSERT(str.length == 10 && strcmp(str.data, ">GET /a ok") == 0, "Batch append incorrect");
+    TEST_ASSERT(sstr_append_many(&str, NULL, 0) == SSTR_SUCCESS, "Empty batch should succeed");
+
+    /* All or nothing */
+    SStrResult result = sstr_append_many(&str, parts, 3);
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(str.length == 10 && strcmp(str.data, ">GET /a ok") == 0,
+                "Content should be unchanged after overflow");
+#else
+    TEST_ASSERT(result == SSTR_SUCCESS && strcmp(str.data, ">GET /a okGET /") == 0,
+                "Should truncate at capacity");
+#endif
+
+    /* A NULL part is rejected before anything is written */
+    sstr_copy(&str, "x");
+    SStrView bad[] = {SSTR_VIEW_LIT("a"), {NULL, 1}};
+    TEST_ASSERT(sstr_append_many(&str, bad, 2) == SSTR_ERROR_NULL, "Should detect NULL part");
+    TEST_ASSERT(strcmp(str.data, "x") == 0, "Content should be unchanged");
+    TEST_ASSERT(sstr_append_many(NULL, parts, 1) == SSTR_ERROR_NULL,
+                "Should detect NULL destination");
+
+    /* Varargs concatenation */
+    sstr_copy(&str, "[");
+    TEST_ASSERT(SSTR_CONCAT(&str, "ab", "", "cd", "]") == SSTR_SUCCESS, "Concat should succeed");
+    TEST_ASSERT(str.length == 6 && strcmp(str.data, "[abcd]") == 0, "Concat result incorrect");
+
+    /* Exactly full is not an overflow */
+    TEST_ASSERT(SSTR_CONCAT(&str, "0123", "45678") == SSTR_SUCCESS, "Concat to capacity");
+    TEST_ASSERT(str.length == str.capacity, "Should fill the capacity");
+
+    sstr_copy(&str, "keep");
+    result = SSTR_CONCAT(&str, "0123456789", "abc");
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(str.length == 4 && strcmp(str.data, "keep") == 0,
+                "Content should be unchanged after overflow");
+#else
+    TEST_ASSERT(result == SSTR_SUCCESS && str.length == str.capacity, "Should truncate");
+#endif
+    TEST_ASSERT(SSTR_CONCAT(NULL, "a") == SSTR_ERROR_NULL, "Should detect NULL destination");
+
+    /* Parts taken from the destination itself */
+    sstr_copy(&str, "abc");
+    TEST_ASSERT(SSTR_CONCAT(&str, "-", str.data) == SSTR_SUCCESS, "Self concat should succeed");
+    TEST_ASSERT(str.length == 7 && strcmp(str.data, "abc-abc") == 0, "Self concat incorrect");
+    sstr_copy(&str, "abc");
+    TEST_ASSERT(SSTR_CONCAT(&str, str.data + 1, "|", str.data, str.data + 3) == SSTR_SUCCESS,
+                "Self concat should succeed");
+    TEST_ASSERT(strcmp(str.data, "abcbc|abc") == 0, "Self concat incorrect");
+    result = sstr_concat_ex(&str, SSTR_TRUNCATE, str.data, NULL);
+    TEST_ASSERT(result == SSTR_SUCCESS && str.length == str.capacity &&
+                    strcmp(str.data, "abcbc|abcabcbc|") == 0,
+                "Self concat should truncate");
+    sstr_copy(&str, "abc");
+    TEST_ASSERT(sstr_concat_ex(&str, SSTR_ERROR, str.data, "0123456789", NULL) ==
+                    SSTR_ERROR_OVERFLOW,
+                "Self concat past capacity should overflow");
+    TEST_ASSERT(strcmp(str.data, "abc") == 0, "Content should be unchanged after overflow");
+
+    return 1;
+}
+
+static int test_policy_ex(void)
+{
+    char buffer[8];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* The same call rejects or truncates depending on the policy argument */
+    sstr_copy(&str, "keep");
+    TEST_ASSERT(sstr_append_ex(&str, "-too-long", SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Error policy should reject overflow");
+    TEST_ASSERT(strcmp(str.data, "keep") == 0, "Content should be unchanged");
+    TEST_ASSERT(sstr_append_ex(&str, "-too-long", SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(str.length == 7 && strcmp(str.data, "keep-to") == 0, "Should truncate");
+
+    TEST_ASSERT(sstr_copy_ex(&str, "0123456789", SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Error policy should reject overflow");
+    TEST_ASSERT(strcmp(str.data, "keep-to") == 0, "Content should be unchanged");
+    TEST_ASSERT(sstr_copy_ex(&str, "0123456789", SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(strcmp(str.data, "0123456") == 0, "Should truncate");
+
+    TEST_ASSERT(sstr_copy_n_ex(&str, "abcdefghij", 10, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Error policy should reject overflow");
+    TEST_ASSERT(sstr_copy_n_ex(&str, "abcdefghij", 10, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(strcmp(str.data, "abcdefg") == 0, "Should truncate");
+
+    char other_buffer[8];
+    SStr other;
+    sstr_init(&other, other_buffer, sizeof(other_buffer));
+    sstr_copy(&other, "12345");
+    sstr_copy(&str, "ab");
+    TEST_ASSERT(sstr_append_sstr_ex(&str, &other, SSTR_ERROR) == SSTR_SUCCESS, "Should fit");
+    TEST_ASSERT(sstr_append_sstr_ex(&str, &other, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(strcmp(str.data, "ab12345") == 0, "Should stop at capacity");
+
+    sstr_copy(&str, "ab");
+    SStrView parts[] = {SSTR_VIEW_LIT("cde"), SSTR_VIEW_LIT("fgh")};
+    TEST_ASSERT(sstr_append_many_ex(&str, parts, 2, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Error policy should reject overflow");
+    TEST_ASSERT(sstr_append_many_ex(&str, parts, 2, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(strcmp(str.data, "abcdefg") == 0, "Should truncate");
+
+    TEST_ASSERT(sstr_copy_view_ex(&str, SSTR_VIEW_LIT("abcdefghij"), SSTR_TRUNCATE) ==
+                    SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    sstr_copy(&str, "x");
+    TEST_ASSERT(SSTR_CONCAT_EX(&str, SSTR_ERROR, "yz", "0123456") == SSTR_ERROR_OVERFLOW,
+                "Error policy should reject overflow");
+    TEST_ASSERT(strcmp(str.data, "x") == 0, "Content should be unchanged");
+    TEST_ASSERT(SSTR_CONCAT_EX(&str, SSTR_TRUNCATE, "yz", "0123456") == SSTR_SUCCESS,
+                "Truncate policy should succeed");
+    TEST_ASSERT(strcmp(str.data, "xyz0123") == 0, "Should truncate");
+
+    /* Unknown policies are rejected */
+    TEST_ASSERT(sstr_append_ex(&str, "a", (SStrTruncationPolicy)42) == SSTR_ERROR_ARGUMENT,
+                "Should reject an unknown policy");
+
+    return 1;
+}
+
+static int test_reserve(void)
+{
+    char buffer[8];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* A fixed buffer can only confirm the space it already has */
+    TEST_ASSERT(sstr_reserve(&str, 7) == SSTR_SUCCESS, "Reserve within capacity should succeed");
+    TEST_ASSERT(sstr_reserve(&str, 8) == SSTR_ERROR_OVERFLOW,
+                "Reserve past a fixed capacity should overflow");
+    TEST_ASSERT(str.data == buffer && str.capacity == 7, "Fixed string should be unchanged");
+    TEST_ASSERT(sstr_reserve(NULL, 1) == SSTR_ERROR_NULL, "NULL string should fail");
+
+    return 1;
+}
+
+/* The macro forms, which are the inline fast paths when SSTR_INLINE_FAST_PATHS
+ * is set, must agree with the library functions named in parentheses */
+static int test_fast_paths(void)
+{
+    char buffer_a[8];
+    char buffer_b[8];
+    SStr a;
+    SStr b;
+    SStr src;
+    char src_buffer[8];
+    sstr_init(&a, buffer_a, sizeof(buffer_a));
+    sstr_init(&b, buffer_b, sizeof(buffer_b));
+    sstr_init(&src, src_buffer, sizeof(src_buffer));
+    sstr_copy(&src, "wxyz");
+
+    TEST_ASSERT(sstr_copy_n(&a, "abcdef", 3) == (sstr_copy_n)(&b, "abcdef", 3),
+                "Copy results should match");
+    TEST_ASSERT(sstr_copy_n(&a, "abcdefghi", 9) == (sstr_copy_n)(&b, "abcdefghi", 9),
+                "Overflowing copy results should match");
+    TEST_ASSERT(sstr_append_sstr(&a, &src) == (sstr_append_sstr)(&b, &src),
+                "Append results should match");
+    TEST_ASSERT(sstr_append_sstr(&a, &src) == (sstr_append_sstr)(&b, &src),
+                "Overflowing append results should match");
+    TEST_ASSERT(a.length == b.length && strcmp(a.data, b.data) == 0, "Contents should match");
+
+    SStrView view = sstr_view_from_cstr("1234567");
+    TEST_ASSERT(sstr_copy_view(&a, view) == (sstr_copy_view)(&b, view),
+                "View copy results should match");
+    view.length = 2;
+    TEST_ASSERT(sstr_append_view(&a, view) == (sstr_append_view)(&b, view),
+                "Overflowing view append results should match");
+    TEST_ASSERT(sstr_clear(&a) == (sstr_clear)(&b), "Clear results should match");
+    TEST_ASSERT(sstr_append_view(&a, view) == (sstr_append_view)(&b, view),
+                "View append results should match");
+    TEST_ASSERT(a.length == b.length && strcmp(a.data, b.data) == 0, "Contents should match");
+
+    /* Arguments the fast paths do not handle reach the library */
+    TEST_ASSERT(sstr_clear(NULL) == SSTR_ERROR_NULL, "NULL clear should fail");
+    TEST_ASSERT(sstr_copy_n(&a, NULL, 0) == SSTR_ERROR_NULL, "NULL source should fail");
+    TEST_ASSERT(sstr_append_sstr(&a, NULL) == SSTR_ERROR_NULL, "NULL source should fail");
+    view.data = NULL;
+    TEST_ASSERT(sstr_copy_view(&a, view) == SSTR_ERROR_NULL, "NULL view should fail");
+    TEST_ASSERT(sstr_append_view(NULL, view) == SSTR_ERROR_NULL, "NULL dest should fail");
+
+    return 1;
+}
+
+static int test_array(void)
+{
+    char block[4 * 8];
+    SStr table[4];
+    TEST_ASSERT(sstr_array_init(table, 4, block, 8) == SSTR_SUCCESS, "Array init should succeed");
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(table[i].data == block + i * 8, "Entries should use consecutive slots");
+        TEST_ASSERT(table[i].capacity == 7 && table[i].length == 0 && table[i].data[0] == '\0',
+                    "Entries should be empty with room for a terminator");
+    }
+    TEST_ASSERT(sstr_array_init(table, 4, block, 0) == SSTR_ERROR_OVERFLOW,
+                "Zero slot size should overflow");
+    TEST_ASSERT(sstr_array_init(table, SIZE_MAX / 4 + 1, block, 8) == SSTR_ERROR_OVERFLOW,
+                "Table size overflow should be detected");
+    TEST_ASSERT(sstr_array_init(NULL, 4, block, 8) == SSTR_ERROR_NULL, "NULL array should fail");
+    TEST_ASSERT(sstr_array_init(table, 4, NULL, 8) == SSTR_ERROR_NULL, "NULL block should fail");
+
+    SStrView views[4] = {sstr_view_from_cstr("eth0"), sstr_view_from_cstr("up"),
+                         sstr_view_from_cstr(""), sstr_view_from_cstr("1500mtu")};
+    TEST_ASSERT(sstr_array_copy_views(table, views, 4) == SSTR_SUCCESS,
+                "Copying views should succeed");
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(table[i].length == views[i].length &&
+                        memcmp(table[i].data, views[i].data, views[i].length) == 0 &&
+                        table[i].data[table[i].length] == '\0',
+                    "Each entry should hold its view");
+    }
+
+    /* Under SSTR_ERROR one view that does not fit leaves every entry unchanged */
+    views[0] = sstr_view_from_cstr("wlan0");
+    views[2] = sstr_view_from_cstr("too long for a slot");
+    TEST_ASSERT(sstr_array_copy_views_ex(table, views, 4, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "A view longer than its entry should overflow");
+    TEST_ASSERT(strcmp(table[0].data, "eth0") == 0 && table[2].length == 0,
+                "Overflow should change no entry");
+    views[1].data = NULL;
+    TEST_ASSERT(sstr_array_copy_views_ex(table, views, 4, SSTR_TRUNCATE) == SSTR_ERROR_NULL,
+                "A NULL view should fail");
+    TEST_ASSERT(strcmp(table[0].data, "eth0") == 0, "A NULL view should change no entry");
+
+    views[1] = sstr_view_from_cstr("down");
+    TEST_ASSERT(sstr_array_copy_views_ex(table, views, 4, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncating copy should succeed");
+    TEST_ASSERT(strcmp(table[0].data, "wlan0") == 0 && strcmp(table[2].data, "too lon") == 0,
+                "Long views should be truncated to their entry");
+    TEST_ASSERT(sstr_array_copy_views_ex(table, views, 4, (SStrTruncationPolicy)42) ==
+                    SSTR_ERROR_ARGUMENT,
+                "Invalid policy should be rejected");
+
+    /* A view may point into its own entry */
+    views[2] = sstr_view_from_cstr("mtu");
+    views[3].data = table[3].data + 4;
+    views[3].length = 3;
+    TEST_ASSERT(sstr_array_copy_views(table, views, 4) == SSTR_SUCCESS, "Copy should succeed");
+    TEST_ASSERT(strcmp(table[3].data, "mtu") == 0, "Self view should be copied");
+
+    TEST_ASSERT(sstr_array_clear(table, 4) == SSTR_SUCCESS, "Array clear should succeed");
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(table[i].length == 0 && table[i].data[0] == '\0', "Entries should be empty");
+    }
+    table[2].data = NULL;
+    TEST_ASSERT(sstr_array_clear(table, 4) == SSTR_ERROR_NULL, "NULL entry should fail");
+    TEST_ASSERT(sstr_array_clear(NULL, 0) == SSTR_SUCCESS, "Empty table should succeed");
+    TEST_ASSERT(sstr_array_copy_views(NULL, NULL, 0) == SSTR_SUCCESS, "Empty table should succeed");
+
+    return 1;
+}
+
+#if SSTR_ENABLE_GROWABLE
+/* Heap allocator that counts calls and can be made to fail */
+typedef struct {
+    int allocations;
+    int frees;
+    size_t fail_above; /* Requests larger than this fail */
+} TestAllocatorState;
+
+static void *test_resize(void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    TestAllocatorState *state = (TestAllocatorState *)ctx;
+    (void)old_size;
+
+    if (new_size == 0) {
+        state->frees++;
+        free(ptr);
+        return NULL;
+    }
+    if (new_size > state->fail_above) {
+        return NULL;
+    }
+
+    state->allocations++;
+    return realloc(ptr, new_size);
+}
+
+static int test_growable(void)
+{
+    TestAllocatorState state = {0, 0, (size_t)-1};
+    SStrAllocator allocator = {test_resize, &state};
+    SStr str;
+
+    TEST_ASSERT(sstr_init_growable(&str, &allocator, 4) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    TEST_ASSERT(str.capacity == 4 && str.length == 0 && str.data[0] == '\0',
+                "Growable string should start empty");
+
+    /* Appends grow geometrically instead of overflowing */
+    TEST_ASSERT(sstr_append(&str, "Hello") == SSTR_SUCCESS, "Append should grow the string");
+    TEST_ASSERT(strcmp(str.data, "Hello") == 0 && str.length == 5, "Content should be 'Hello'");
+    TEST_ASSERT(str.capacity == 9, "Capacity should double");
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT(sstr_append(&str, "0123456789") == SSTR_SUCCESS, "Repeated appends");
+    }
+    TEST_ASSERT(str.length == 1005, "Length should count every append");
+    TEST_ASSERT(state.allocations < 12, "Growth should be geometric");
+
+    /* Appending a string to itself survives the buffer moving */
+    sstr_copy(&str, "abc");
+    size_t capacity = str.capacity;
+    while (str.length <= capacity) {
+        TEST_ASSERT(sstr_append_sstr(&str, &str) == SSTR_SUCCESS, "Self append should succeed");
+    }
+    TEST_ASSERT(strncmp(str.data + str.length - 6, "abcabc", 6) == 0,
+                "Self append should copy the content");
+
+    /* Views, batches, concatenation and integers grow as well */
+    TestAllocatorState grown_state = {0, 0, (size_t)-1};
+    SStrAllocator grown_allocator = {test_resize, &grown_state};
+    SStr grown;
+    TEST_ASSERT(sstr_init_growable(&grown, &grown_allocator, 2) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    TEST_ASSERT(sstr_append_view(&grown, SSTR_VIEW_LIT("hello")) == SSTR_SUCCESS,
+                "View append should grow the string");
+    TEST_ASSERT(strcmp(grown.data, "hello") == 0, "View append content incorrect");
+    SStrView parts[2] = {sstr_view_from_sstr(&grown), SSTR_VIEW_LIT("|")};
+    TEST_ASSERT(sstr_append_many(&grown, parts, 2) == SSTR_SUCCESS,
+                "Batch append should grow the string");
+    TEST_ASSERT(strcmp(grown.data, "hellohello|") == 0, "Batch append content incorrect");
+    TEST_ASSERT(sstr_concat(&grown, "-", "0123456789012345678901234567890123456789", "!", NULL) ==
+                    SSTR_SUCCESS,
+                "Concat should grow the string");
+    TEST_ASSERT(grown.length == 53 && strcmp(grown.data + 50, "89!") == 0,
+                "Concat content incorrect");
+    while (grown.length < grown.capacity) {
+        sstr_append(&grown, "x");
+    }
+    size_t full = grown.length;
+    TEST_ASSERT(sstr_append_i64(&grown, -42) == SSTR_SUCCESS, "Integer append should grow");
+    TEST_ASSERT(strcmp(grown.data + full, "-42") == 0, "Integer append content incorrect");
+    TEST_ASSERT(sstr_append_hex(&grown, 0xff, 2000, 0) == SSTR_SUCCESS,
+                "Padded hex append should grow");
+    TEST_ASSERT(grown.length == full + 2003 && strcmp(grown.data + grown.length - 3, "0ff") == 0,
+                "Padded hex content incorrect");
+    size_t before = grown.length;
+    TEST_ASSERT(sstr_concat(&grown, grown.data, ">", NULL) == SSTR_SUCCESS,
+                "Self concat should grow the string");
+    TEST_ASSERT(grown.length == 2 * before + 1 &&
+                    strncmp(grown.data + before, "hellohello|-", 12) == 0 &&
+                    strcmp(grown.data + grown.length - 4, "0ff>") == 0,
+                "Self concat content incorrect");
+    sstr_free(&grown);
+    TEST_ASSERT(grown_state.frees == 1, "Grown buffer should be freed");
+
+    /* Parts after the one that grows the string still find dest's content */
+    TEST_ASSERT(sstr_init_growable(&grown, &grown_allocator, 4) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    sstr_copy(&grown, "abcd");
+    TEST_ASSERT(SSTR_CONCAT(&grown, "x", grown.data) == SSTR_SUCCESS,
+                "Self concat after growth should succeed");
+    TEST_ASSERT(grown.length == 9 && strcmp(grown.data, "abcdxabcd") == 0,
+                "Self concat after growth incorrect");
+    sstr_free(&grown);
+    TEST_ASSERT(sstr_init_growable(&grown, &grown_allocator, 4) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    sstr_copy(&grown, "abcd");
+    TEST_ASSERT(SSTR_CONCAT(&grown, grown.data, "x", grown.data) == SSTR_SUCCESS,
+                "Repeated self concat should succeed");
+    TEST_ASSERT(grown.length == 13 && strcmp(grown.data, "abcdabcdxabcd") == 0,
+                "Repeated self concat incorrect");
+    sstr_free(&grown);
+
+#if SSTR_ENABLE_FORMAT
+    /* Formatting grows too, replacing or appending */
+    sstr_clear(&str);
+    sstr_reserve(&str, 0);
+    TEST_ASSERT(sstr_format(&str, "%s=%d", "answer", 42) == 9, "Format should succeed");
+    TEST_ASSERT(strcmp(str.data, "answer=42") == 0, "Format content incorrect");
+    int result = sstr_append_format(&str, "%2000d|", 7);
+    TEST_ASSERT(result == 2001, "Append format should grow the string");
+    TEST_ASSERT(str.length == 2010 && str.data[2009] == '|', "Append format content incorrect");
+
+    /* Arguments taken from dest survive the buffer moving */
+    SStr self;
+    TEST_ASSERT(sstr_init_growable(&self, &allocator, 4) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    sstr_copy(&self, "abcd");
+    TEST_ASSERT(sstr_append_format(&self, "%s%s", self.data, self.data) == 8,
+                "Self append format should grow the string");
+    TEST_ASSERT(strcmp(self.data, "abcdabcdabcd") == 0, "Self append format content incorrect");
+    TEST_ASSERT(sstr_format(&self, "%s-%s", self.data, self.data) == 25,
+                "Self format should grow the string");
+    TEST_ASSERT(strcmp(self.data, "abcdabcdabcd-abcdabcdabcd") == 0,
+                "Self format content incorrect");
+    sstr_free(&self);
+#endif
+
+    /* A failed growth falls back to the policy and keeps the content */
+    capacity = str.capacity;
+    size_t length = str.length;
+    state.fail_above = capacity + 1;
+    char big[4200];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    TEST_ASSERT(sstr_append_ex(&str, big, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Allocator failure should overflow");
+    TEST_ASSERT(str.length == length && str.data[length] == '\0', "Content should be unchanged");
+    TEST_ASSERT(sstr_append_ex(&str, big, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Allocator failure should truncate");
+    TEST_ASSERT(str.length == capacity, "Truncation should fill the buffer");
+    TEST_ASSERT(sstr_reserve(&str, capacity + 1) == SSTR_ERROR_OVERFLOW,
+                "Reserve should report allocator failure");
+    state.fail_above = (size_t)-1;
+
+    /* Reserve pre-sizes the buffer */
+    TEST_ASSERT(sstr_reserve(&str, 60000) == SSTR_SUCCESS, "Reserve should grow");
+    TEST_ASSERT(str.capacity >= 60000, "Reserve should provide the capacity");
+    TEST_ASSERT(sstr_reserve(&str, SSTR_CAPACITY_MAX + (size_t)1) == SSTR_ERROR_OVERFLOW,
+                "Reserve past SSTR_CAPACITY_MAX should fail");
+
+    /* Free releases the buffer once */
+    int frees = state.frees;
+    TEST_ASSERT(sstr_free(&str) == SSTR_SUCCESS, "Free should succeed");
+    TEST_ASSERT(state.frees == frees + 1, "Buffer should be freed");
+    TEST_ASSERT(str.data == NULL && str.capacity == 0, "Freed string has no buffer");
+    TEST_ASSERT(sstr_append(&str, "x") == SSTR_ERROR_NULL, "Freed string should be unusable");
+
+    /* The heap allocator and fixed strings */
+    TEST_ASSERT(sstr_init_growable(&str, &sstr_heap_allocator, 0) == SSTR_SUCCESS,
+                "Heap allocator init should succeed");
+    TEST_ASSERT(sstr_append(&str, "growing") == SSTR_SUCCESS, "Heap append should succeed");
+    sstr_free(&str);
+
+    char buffer[4];
+    SStr fixed;
+    sstr_init(&fixed, buffer, sizeof(buffer));
+    TEST_ASSERT(sstr_append(&fixed, "toolong") == SSTR_ERROR_OVERFLOW,
+                "Fixed strings should still overflow");
+    TEST_ASSERT(sstr_free(&fixed) == SSTR_SUCCESS && fixed.data == buffer,
+                "Free should leave fixed strings alone");
+
+    TEST_ASSERT(sstr_init_growable(&str, NULL, 4) == SSTR_ERROR_NULL, "NULL allocator");
+    state.fail_above = 0;
+    TEST_ASSERT(sstr_init_growable(&str, &allocator, 4) == SSTR_ERROR_OVERFLOW,
+                "Failed initial allocation should overflow");
+
+    return 1;
+}
+#endif
+
+SSTR_DECLARE_INLINE(TestKey, 7);
+
+static int test_inline(void)
+{
+    TestKey key;
+    TEST_ASSERT(SSTR_INLINE_INIT(&key) == SSTR_SUCCESS, "Inline init should succeed");
+    TEST_ASSERT(key.str.data == key.buf, "Header should point at the inline buffer");
+    TEST_ASSERT(key.str.capacity == 7 && key.str.length == 0, "Capacity should be N");
+
+    /* Existing functions work on the header */
+    TEST_ASSERT(sstr_copy(&key.str, "abc") == SSTR_SUCCESS, "Copy should succeed");
+    TEST_ASSERT(sstr_append(&key.str, "defg") == SSTR_SUCCESS, "Append should fill N");
+    TEST_ASSERT(strcmp(key.buf, "abcdefg") == 0, "Content should be in the inline buffer");
+    TEST_ASSERT(sstr_append(&key.str, "h") == SSTR_ERROR_OVERFLOW, "Capacity should be N");
+
+    /* Arrays are contiguous, and copies are rebound to their own buffer */
+    TestKey keys[3];
+    for (int i = 0; i < 3; i++) {
+        SSTR_INLINE_INIT(&keys[i]);
+        sstr_append_i64(&keys[i].str, i);
+    }
+    TEST_ASSERT((char *)&keys[1] - (char *)&keys[0] == (ptrdiff_t)sizeof(TestKey),
+                "Array elements should be adjacent");
+    TestKey copy = keys[2];
+    SSTR_INLINE_REBIND(&copy);
+    TEST_ASSERT(copy.str.data == copy.buf && strcmp(copy.str.data, "2") == 0,
+                "Rebound copy should use its own buffer");
+    sstr_append(&copy.str, "x");
+    TEST_ASSERT(strcmp(keys[2].str.data, "2") == 0, "Original should be unaffected");
+
+    return 1;
+}
+
+static int test_length_bits(void)
+{
+#if SSTR_LENGTH_BITS == 0
+    TEST_ASSERT(sizeof(sstr_len_t) == sizeof(size_t), "Default fields should be size_t");
+#else
+    TEST_ASSERT(sizeof(sstr_len_t) * 8 == SSTR_LENGTH_BITS, "Field width should match config");
+#endif
+    TEST_ASSERT(SSTR_CAPACITY_MAX < SSTR_LENGTH_MAX, "Capacity + 1 should fit the fields");
+
+#if SSTR_LENGTH_BITS == 16
+    /* A buffer larger than the fields can describe is used up to the limit */
+    static char big_buffer[70000];
+    SStr big;
+    TEST_ASSERT(sstr_init(&big, big_buffer, sizeof(big_buffer)) == SSTR_SUCCESS,
+                "Large buffer init should succeed");
+    TEST_ASSERT(big.capacity == UINT16_MAX - 1, "Capacity should be clamped");
+    memset(big_buffer, 'a', sizeof(big_buffer) - 1);
+    big_buffer[sizeof(big_buffer) - 1] = '\0';
+    char src[70001];
+    memset(src, 'b', sizeof(src) - 1);
+    src[sizeof(src) - 1] = '\0';
+    TEST_ASSERT(sstr_copy(&big, src) == SSTR_ERROR_OVERFLOW, "Copy past the limit should fail");
+    src[UINT16_MAX - 1] = '\0';
+    TEST_ASSERT(sstr_copy(&big, src) == SSTR_SUCCESS, "Copy up to the limit should succeed");
+    TEST_ASSERT(big.length == UINT16_MAX - 1, "Length should reach the limit");
+#endif
+
+    return 1;
+}
+
+#if SSTR_ENABLE_STATS
+static int test_stats(void)
+{
+    char buffer[11];
+    SStr str;
+    SStrStats stats;
+
+    sstr_init(&str, buffer, sizeof(buffer));
+    sstr_stats_reset();
+    TEST_ASSERT(sstr_stats_snapshot(&stats) == SSTR_SUCCESS, "Snapshot should succeed");
+    TEST_ASSERT(stats.api[SSTR_STATS_COPY].calls == 0 && stats.high_water_permille == 0,
+                "Reset should zero the counters");
+
+    /* Copies: one that fits, one truncated, one rejected */
+    TEST_ASSERT(sstr_copy_ex(&str, "hello", SSTR_ERROR) == SSTR_SUCCESS, "Copy should succeed");
+    TEST_ASSERT(sstr_copy_ex(&str, "hello, world", SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncating copy should succeed");
+    TEST_ASSERT(sstr_copy_view_ex(&str, SSTR_VIEW_LIT("far too long"), SSTR_ERROR) ==
+                    SSTR_ERROR_OVERFLOW,
+                "Rejected copy should overflow");
+
+    /* Appends, with the same outcomes */
+    sstr_clear(&str);
+    TEST_ASSERT(sstr_append_ex(&str, "abc", SSTR_ERROR) == SSTR_SUCCESS, "Append should succeed");
+    TEST_ASSERT(sstr_append_ex(&str, "defghijkl", SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncating append should succeed");
+    TEST_ASSERT(sstr_append_ex(&str, "x", SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Append to a full string should overflow");
+
+#if SSTR_ENABLE_FORMAT
+    /* Formats */
+    TEST_ASSERT(sstr_format_ex(&str, SSTR_ERROR, "%d", 42) == 2, "Format should succeed");
+    TEST_ASSERT(sstr_append_format_ex(&str, SSTR_TRUNCATE, "%s", "0123456789") == 10,
+                "Truncating format should report the full length");
+#endif
+
+    /* NULL arguments are not counted */
+    TEST_ASSERT(sstr_append(NULL, "x") == SSTR_ERROR_NULL, "NULL dest should fail");
+
+    sstr_stats_snapshot(&stats);
+    const SStrStatsCounters *copy = &stats.api[SSTR_STATS_COPY];
+    const SStrStatsCounters *append = &stats.api[SSTR_STATS_APPEND];
+    TEST_ASSERT(copy->calls == 3 && copy->bytes == 15 && copy->overflows == 1 &&
+                    copy->truncations == 1,
+                "Copies should be counted");
+    TEST_ASSERT(append->calls == 3 && append->bytes == 10 && append->overflows == 1 &&
+                    append->truncations == 1,
+                "Appends should be counted");
+#if SSTR_ENABLE_FORMAT
+    const SStrStatsCounters *format = &stats.api[SSTR_STATS_FORMAT];
+    TEST_ASSERT(format->calls == 2 && format->bytes == 10 && format->overflows == 0 &&
+                    format->truncations == 1,
+                "Formats should be counted");
+#endif
+    TEST_ASSERT(stats.high_water_permille == 1000, "A full buffer should reach 1000");
+
+    sstr_stats_reset();
+    sstr_copy(&str, "hello");
+    sstr_stats_snapshot(&stats);
+    TEST_ASSERT(stats.high_water_permille == 500, "Half full should be 500");
+
+    /* The integer appenders and the encoders count as appends */
+    sstr_clear(&str);
+    sstr_stats_reset();
+    TEST_ASSERT(sstr_append_i64_ex(&str, -42, SSTR_ERROR) == SSTR_SUCCESS,
+                "Integer append should succeed");
+    TEST_ASSERT(sstr_append_hex_bytes_ex(&str, "\x01\x02", 2, 0, SSTR_ERROR) == SSTR_SUCCESS,
+                "Hex append should succeed");
+    TEST_ASSERT(sstr_append_base64_ex(&str, "abcdef", 6, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Rejected base64 append should overflow");
+    TEST_ASSERT(sstr_append_json_escaped_ex(&str, SSTR_VIEW_LIT("a\"bc"), SSTR_TRUNCATE) ==
+                    SSTR_SUCCESS,
+                "Truncating JSON append should succeed");
+    TEST_ASSERT(sstr_append_u64_ex(&str, 7, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Integer append to a full string should overflow");
+    sstr_stats_snapshot(&stats);
+    append = &stats.api[SSTR_STATS_APPEND];
+    TEST_ASSERT(append->calls == 5 && append->bytes == 10 && append->overflows == 2 &&
+                    append->truncations == 1,
+                "Integer and encoder appends should be counted");
+    TEST_ASSERT(stats.high_water_permille == 1000, "A full buffer should reach 1000");
+    TEST_ASSERT(sstr_stats_snapshot(NULL) == SSTR_ERROR_NULL, "NULL snapshot should fail");
+
+    return 1;
+}
+#endif
+
 int run_core_tests(void)
 {
     int passed = 0;
@@ -248,6 +1226,108 @@ int run_core_tests(void)
         printf("PASS: append_sstr tests\n");
     }
 
+    total++;
+    if (test_copy_scan()) {
+        passed++;
+        printf("PASS: copy scan tests\n");
+    }
+
+#ifdef MAP_ANONYMOUS
+    total++;
+    if (test_scan_guard_page()) {
+        passed++;
+        printf("PASS: scan guard page tests\n");
+    }
+#endif
+
+    total++;
+    if (test_case_convert()) {
+        passed++;
+        printf("PASS: case conversion tests\n");
+    }
+
+    total++;
+    if (test_trim()) {
+        passed++;
+        printf("PASS: trim tests\n");
+    }
+
+    total++;
+    if (test_view()) {
+        passed++;
+        printf("PASS: view tests\n");
+    }
+
+    total++;
+    if (test_compare()) {
+        passed++;
+        printf("PASS: compare tests\n");
+    }
+
+    total++;
+    if (test_hash()) {
+        passed++;
+        printf("PASS: hash tests\n");
+    }
+
+    total++;
+    if (test_append_many()) {
+        passed++;
+        printf("PASS: append_many tests\n");
+    }
+
+    total++;
+    if (test_policy_ex()) {
+        passed++;
+        printf("PASS: policy tests\n");
+    }
+
+    total++;
+    if (test_inline()) {
+        passed++;
+        printf("PASS: inline string tests\n");
+    }
+
+    total++;
+    if (test_length_bits()) {
+        passed++;
+        printf("PASS: length field tests\n");
+    }
+
+    total++;
+    if (test_reserve()) {
+        passed++;
+        printf("PASS: reserve tests\n");
+    }
+
+    total++;
+    if (test_fast_paths()) {
+        passed++;
+        printf("PASS: fast path tests\n");
+    }
+
+    total++;
+    if (test_array()) {
+        passed++;
+        printf("PASS: string array tests\n");
+    }
+
+#if SSTR_ENABLE_GROWABLE
+    total++;
+    if (test_growable()) {
+        passed++;
+        printf("PASS: growable string tests\n");
+    }
+#endif
+
+#if SSTR_ENABLE_STATS
+    total++;
+    if (test_stats()) {
+        passed++;
+        printf("PASS: statistics tests\n");
+    }
+#endif
+
     printf("Core tests: %d/%d passed\n", passed, total);
     return passed == total;
 }
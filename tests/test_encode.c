@@ -0,0 +1,261 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+static int test_json_escaped(void)
+{
+    char buffer[256];
+    char input[200];
+    char expected[256];
+    SStr s;
+
+    sstr_init(&s, buffer, sizeof(buffer));
+    TEST_ASSERT(sstr_append_json_escaped(&s, SSTR_VIEW_LIT("plain text")) == SSTR_SUCCESS &&
+                    strcmp(s.data, "plain text") == 0,
+                "Text without specials should copy unchanged");
+
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_json_escaped(&s, SSTR_VIEW_LIT("a\"b\\c\nd\te\rf\bg\fh")) ==
+                        SSTR_SUCCESS &&
+                    strcmp(s.data, "a\\\"b\\\\c\\nd\\te\\rf\\bg\\fh") == 0,
+                "Short escapes should be used");
+
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_json_escaped(&s, SSTR_VIEW_LIT("\x01\x1f\x7f\xc3\xa9")) ==
+                        SSTR_SUCCESS &&
+                    strcmp(s.data, "\\u0001\\u001f\x7f\xc3\xa9") == 0,
+                "Other controls should use \\u00XX and high bytes pass through");
+
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_json_escaped(&s, SSTR_VIEW_LIT("\0x")) == SSTR_SUCCESS &&
+                    strcmp(s.data, "\\u0000x") == 0 && s.length == 7,
+                "Embedded NUL should be escaped");
+
+    /* One special at every position of a run longer than the SIMD stride */
+    for (size_t pos = 0; pos < sizeof(input); pos++) {
+        memset(input, 'a', sizeof(input));
+        input[pos] = pos % 3 == 0 ? '"' : (pos % 3 == 1 ? '\x05' : '\\');
+        memset(expected, 'a', pos);
+        size_t escape_len = pos % 3 == 1 ? 6 : 2;
+        memcpy(expected + pos, pos % 3 == 0 ? "\\\"" : (pos % 3 == 1 ? "\\u0005" : "\\\\"),
+               escape_len);
+        memset(expected + pos + escape_len, 'a', sizeof(input) - pos - 1);
+
+        sstr_clear(&s);
+        TEST_ASSERT(sstr_append_json_escaped(&s, (SStrView){input, sizeof(input)}) ==
+                        SSTR_SUCCESS,
+                    "Long run should escape");
+        TEST_ASSERT(s.length == sizeof(input) - 1 + escape_len &&
+                        memcmp(s.data, expected, s.length) == 0,
+                    "Special should be escaped wherever it falls");
+    }
+
+    /* Exact fit, then one short */
+    char small[9];
+    sstr_init(&s, small, sizeof(small));
+    TEST_ASSERT(sstr_append_json_escaped(&s, SSTR_VIEW_LIT("ab\ncd\"")) == SSTR_SUCCESS &&
+                    strcmp(s.data, "ab\\ncd\\\"") == 0,
+                "Escaped output filling the capacity should fit");
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_json_escaped_ex(&s, SSTR_VIEW_LIT("abc\ndef\""), SSTR_ERROR) ==
+                        SSTR_ERROR_OVERFLOW &&
+                    s.length == 0,
+                "SSTR_ERROR should leave dest unchanged");
+    TEST_ASSERT(sstr_append_json_escaped_ex(&s, SSTR_VIEW_LIT("abcdefg\n"), SSTR_TRUNCATE) ==
+                        SSTR_SUCCESS &&
+                    strcmp(s.data, "abcdefg") == 0,
+                "Truncation should not split an escape");
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_json_escaped_ex(&s, SSTR_VIEW_LIT("abcd\x01"), SSTR_TRUNCATE) ==
+                        SSTR_SUCCESS &&
+                    strcmp(s.data, "abcd") == 0,
+                "Truncation should not split a \\u escape");
+
+    TEST_ASSERT(sstr_append_json_escaped(NULL, SSTR_VIEW_LIT("x")) == SSTR_ERROR_NULL,
+                "NULL dest should fail");
+    TEST_ASSERT(sstr_append_json_escaped_ex(&s, SSTR_VIEW_LIT("x"), (SStrTruncationPolicy)9) ==
+                    SSTR_ERROR_ARGUMENT,
+                "Invalid policy should fail");
+
+    return 1;
+}
+
+static int test_hex_bytes(void)
+{
+    char buffer[64];
+    char small[6];
+    const unsigned char bytes[] = {0x00, 0x01, 0x7f, 0x80, 0xab, 0xff};
+    SStr s;
+
+    sstr_init(&s, buffer, sizeof(buffer));
+    TEST_ASSERT(sstr_append_hex_bytes(&s, bytes, sizeof(bytes), 0) == SSTR_SUCCESS &&
+                    strcmp(s.data, "00017f80abff") == 0,
+                "Lowercase hex should encode every byte");
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_hex_bytes(&s, bytes, sizeof(bytes), 1) == SSTR_SUCCESS &&
+                    strcmp(s.data, "00017F80ABFF") == 0,
+                "Uppercase hex should encode every byte");
+    TEST_ASSERT(sstr_append_hex_bytes(&s, bytes, 0, 0) == SSTR_SUCCESS && s.length == 12,
+                "Zero bytes should append nothing");
+
+    sstr_init(&s, small, sizeof(small));
+    TEST_ASSERT(sstr_append_hex_bytes_ex(&s, bytes, 3, 0, SSTR_ERROR) == SSTR_ERROR_OVERFLOW &&
+                    s.length == 0,
+                "SSTR_ERROR should leave dest unchanged");
+    TEST_ASSERT(sstr_append_hex_bytes_ex(&s, bytes, 3, 0, SSTR_TRUNCATE) == SSTR_SUCCESS &&
+                    strcmp(s.data, "0001") == 0,
+                "Truncation should keep whole digit pairs");
+
+#if SSTR_LENGTH_BITS == 16
+    /* Input whose encoding no SStr can hold is still truncated */
+    static unsigned char large[40000];
+    sstr_init(&s, buffer, sizeof(buffer));
+    TEST_ASSERT(sstr_append_hex_bytes_ex(&s, large, sizeof(large), 0, SSTR_ERROR) ==
+                        SSTR_ERROR_OVERFLOW &&
+                    s.length == 0,
+                "SSTR_ERROR should reject oversized input");
+    TEST_ASSERT(sstr_append_hex_bytes_ex(&s, large, sizeof(large), 0, SSTR_TRUNCATE) ==
+                        SSTR_SUCCESS &&
+                    s.length == 62,
+                "Oversized input should truncate to whole digit pairs");
+#endif
+
+    TEST_ASSERT(sstr_append_hex_bytes(&s, NULL, 1, 0) == SSTR_ERROR_NULL,
+                "NULL data should fail");
+
+    return 1;
+}
+
+static int test_base64(void)
+{
+    char buffer[64];
+    char small[10];
+    SStr s;
+
+    /* RFC 4648 section 10 test vectors */
+    static const char *const vectors[][2] = {
+        {"", ""},           {"f", "Zg=="},         {"fo", "Zm8="},         {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+
+    sstr_init(&s, buffer, sizeof(buffer));
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        sstr_clear(&s);
+        TEST_ASSERT(sstr_append_base64(&s, vectors[i][0], strlen(vectors[i][0])) == SSTR_SUCCESS &&
+                        strcmp(s.data, vectors[i][1]) == 0,
+                    "RFC 4648 vector should encode");
+    }
+
+    const unsigned char high[] = {0xfb, 0xff, 0xfe};
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_base64(&s, high, sizeof(high)) == SSTR_SUCCESS &&
+                    strcmp(s.data, "+//+") == 0,
+                "High bytes should use '+' and '/'");
+
+    sstr_init(&s, small, sizeof(small));
+    TEST_ASSERT(sstr_append_base64_ex(&s, "foobar!", 7, SSTR_ERROR) == SSTR_ERROR_OVERFLOW &&
+                    s.length == 0,
+                "SSTR_ERROR should leave dest unchanged");
+    TEST_ASSERT(sstr_append_base64_ex(&s, "foobar!", 7, SSTR_TRUNCATE) == SSTR_SUCCESS &&
+                    strcmp(s.data, "Zm9vYmFy") == 0,
+                "Truncation should keep whole groups");
+    sstr_clear(&s);
+    TEST_ASSERT(sstr_append_base64_ex(&s, "foo", 3, SSTR_TRUNCATE) == SSTR_SUCCESS &&
+                    strcmp(s.data, "Zm9v") == 0,
+                "Output that fits should not be truncated");
+
+#if SSTR_LENGTH_BITS == 16
+    static unsigned char large[60000];
+    sstr_init(&s, buffer, sizeof(buffer));
+    TEST_ASSERT(sstr_append_base64_ex(&s, large, sizeof(large), SSTR_ERROR) ==
+                        SSTR_ERROR_OVERFLOW &&
+                    s.length == 0,
+                "SSTR_ERROR should reject oversized input");
+    TEST_ASSERT(sstr_append_base64_ex(&s, large, sizeof(large), SSTR_TRUNCATE) == SSTR_SUCCESS &&
+                    s.length == 60 && strncmp(s.data, "AAAA", 4) == 0,
+                "Oversized input should truncate to whole groups");
+#endif
+
+#if SSTR_ENABLE_GROWABLE
+    /* A growable destination takes the whole encoding whatever the policy */
+    SStr grown;
+    TEST_ASSERT(sstr_init_growable(&grown, &sstr_heap_allocator, 2) == SSTR_SUCCESS,
+                "Growable init should succeed");
+    TEST_ASSERT(sstr_append_base64_ex(&grown, "foobar", 6, SSTR_ERROR) == SSTR_SUCCESS &&
+                    strcmp(grown.data, "Zm9vYmFy") == 0,
+                "Growable dest should grow to fit");
+    sstr_free(&grown);
+
+    /* Encoding dest's own content survives the buffer moving */
+    sstr_init_growable(&grown, &sstr_heap_allocator, 3);
+    sstr_copy(&grown, "a\"b");
+    TEST_ASSERT(sstr_append_json_escaped(&grown, sstr_view_from_sstr(&grown)) == SSTR_SUCCESS &&
+                    strcmp(grown.data, "a\"ba\\\"b") == 0,
+                "Self JSON escape should grow");
+    sstr_free(&grown);
+    sstr_init_growable(&grown, &sstr_heap_allocator, 3);
+    sstr_copy(&grown, "abc");
+    TEST_ASSERT(sstr_append_hex_bytes(&grown, grown.data, grown.length, 0) == SSTR_SUCCESS &&
+                    strcmp(grown.data, "abc616263") == 0,
+                "Self hex encode should grow");
+    sstr_free(&grown);
+    sstr_init_growable(&grown, &sstr_heap_allocator, 3);
+    sstr_copy(&grown, "foo");
+    TEST_ASSERT(sstr_append_base64(&grown, grown.data, grown.length) == SSTR_SUCCESS &&
+                    strcmp(grown.data, "fooZm9v") == 0,
+                "Self base64 encode should grow");
+    sstr_free(&grown);
+#endif
+
+    return 1;
+}
+
+int run_encode_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running encode tests...\n");
+
+    total++;
+    if (test_json_escaped()) {
+        passed++;
+        printf("PASS: JSON escape tests\n");
+    }
+
+    total++;
+    if (test_hex_bytes()) {
+        passed++;
+        printf("PASS: hex bytes tests\n");
+    }
+
+    total++;
+    if (test_base64()) {
+        passed++;
+        printf("PASS: base64 tests\n");
+    }
+
+    printf("Encode tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
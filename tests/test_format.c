@@ -9,7 +9,10 @@
  */
 
 #include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -21,6 +24,7 @@
         }                                                                                          \
     } while (0)
 
+#if SSTR_ENABLE_FORMAT
 static int test_format_basic(void)
 {
     char buffer[64];
@@ -61,10 +65,16 @@ static int test_format_overflow(void)
     int result = sstr_format(&small_str, "This string is too long to fit");
     TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
 
-    /* Create a new version with TRUNCATE policy */
-    /* Note: We can't actually change the policy at runtime since our implementation
-     * uses #if not if(), but we can simulate a truncate policy by
-     * using a string that's only slightly too long */
+    /* Either policy can be requested per call */
+    sstr_copy(&small_str, "keep");
+    result = sstr_format_ex(&small_str, SSTR_ERROR, "%s", "much too long");
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Error policy should reject overflow");
+    TEST_ASSERT(strcmp(small_str.data, "keep") == 0, "Content should be unchanged after overflow");
+    result = sstr_format_ex(&small_str, SSTR_TRUNCATE, "%s", "much too long");
+    TEST_ASSERT(result == 13, "Truncate policy should report the full length");
+    TEST_ASSERT(strcmp(small_str.data, "much too ") == 0, "Output should be truncated");
+    TEST_ASSERT(sstr_format_ex(&small_str, (SStrTruncationPolicy)42, "x") == SSTR_ERROR_ARGUMENT,
+                "Should reject an unknown policy");
 
     /* Test either error or truncation based on compile-time policy */
     sstr_clear(&small_str);
@@ -85,6 +95,27 @@ static int test_format_overflow(void)
     TEST_ASSERT(small_str.data[small_str.length] == '\0', "String should be null-terminated");
 #endif
 
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    /* A failed format must leave existing contents untouched */
+    sstr_copy(&small_str, "keep");
+    result = sstr_format(&small_str, "%s", "much too long for this");
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(small_str.length == 4, "Length should be unchanged after overflow");
+    TEST_ASSERT(strcmp(small_str.data, "keep") == 0, "Content should be unchanged after overflow");
+
+    /* Output that fits the buffer but not the free tail still succeeds */
+    result = sstr_format(&small_str, "%s", "12345678");
+    TEST_ASSERT(result == 8, "Format should succeed when output fits the capacity");
+    TEST_ASSERT(strcmp(small_str.data, "12345678") == 0, "Content should be replaced");
+
+    /* A full buffer still formats correctly */
+    result = sstr_format(&small_str, "%d", 123456789);
+    TEST_ASSERT(result == 9, "Format into full-capacity output should succeed");
+    result = sstr_format(&small_str, "%d", 42);
+    TEST_ASSERT(result == 2, "Format after a full buffer should succeed");
+    TEST_ASSERT(strcmp(small_str.data, "42") == 0, "Content should be '42'");
+#endif
+
 /* Reset policy for other tests */
 #undef SSTR_DEFAULT_POLICY
 #define SSTR_DEFAULT_POLICY SSTR_ERROR
@@ -197,6 +228,341 @@ static int test_format_validation(void)
     return 1;
 }
 
+/* Compare sstr_format output against the C library for one conversion */
+#define CHECK_LIKE_SNPRINTF(str, fmt, ...)                                                         \
+    do {                                                                                           \
+        char expected[128];                                                                        \
+        int expected_len = snprintf(expected, sizeof(expected), fmt, __VA_ARGS__);                 \
+        int actual_len = sstr_format(str, fmt, __VA_ARGS__);                                       \
+        TEST_ASSERT(actual_len == expected_len, "Length differs from snprintf for " fmt);          \
+        TEST_ASSERT(strcmp((str)->data, expected) == 0, "Output differs from snprintf for " fmt);  \
+    } while (0)
+
+static int test_format_conversions(void)
+{
+    char buffer[128];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* Signed and unsigned decimal, including the extremes */
+    CHECK_LIKE_SNPRINTF(&str, "%d|%i|%u", 0, -1, 0u);
+    CHECK_LIKE_SNPRINTF(&str, "%d|%d", 2147483647, -2147483647 - 1);
+    CHECK_LIKE_SNPRINTF(&str, "%u", 4294967295u);
+    CHECK_LIKE_SNPRINTF(&str, "%lld|%llu", -9223372036854775807LL - 1, 18446744073709551615ULL);
+
+    /* Hexadecimal */
+    CHECK_LIKE_SNPRINTF(&str, "%x|%X|%#x|%#X|%#x", 0xdeadbeefu, 0xabcu, 255u, 255u, 0u);
+    CHECK_LIKE_SNPRINTF(&str, "%08x|%-8X|%.6x", 0x1fu, 0x1fu, 0x1fu);
+
+    /* Flags, width and precision */
+    CHECK_LIKE_SNPRINTF(&str, "[%5d][%-5d][%05d][%+d][% d]", 42, 42, 42, 42, 42);
+    CHECK_LIKE_SNPRINTF(&str, "[%05d][%+05d][%-+6d][% 05d]", -42, 42, 42, 42);
+    CHECK_LIKE_SNPRINTF(&str, "[%.5d][%8.5d][%-8.5d]", -42, 42, 42);
+    CHECK_LIKE_SNPRINTF(&str, "[%.0d][%5.0d][%.0x][%#.0x]", 0, 0, 0u, 0u);
+
+    /* Length modifiers */
+    CHECK_LIKE_SNPRINTF(&str, "%hhd|%hhu|%hd|%hu", 300, 300, 70000, 70000);
+    CHECK_LIKE_SNPRINTF(&str, "%ld|%lu|%lx", -123456789L, 123456789UL, 0xfeedUL);
+    CHECK_LIKE_SNPRINTF(&str, "%zu|%zx|%td", (size_t)12345, (size_t)0xabc, (ptrdiff_t)-77);
+    CHECK_LIKE_SNPRINTF(&str, "%jd|%ju", (intmax_t)-5, (uintmax_t)5);
+
+    /* Characters and strings */
+    CHECK_LIKE_SNPRINTF(&str, "[%c][%3c][%-3c]", 'a', 'b', 'c');
+    CHECK_LIKE_SNPRINTF(&str, "[%s][%8s][%-8s][%.2s][%6.2s]", "abc", "abc", "abc", "abc", "abc");
+    CHECK_LIKE_SNPRINTF(&str, "[%.10s][%s]", "short", "");
+    CHECK_LIKE_SNPRINTF(&str, "%d%%%s", 100, "!");
+
+#if SSTR_NATIVE_FORMAT
+    /* A NULL string argument is rejected rather than printed */
+    int null_result = sstr_format(&str, "%s", (const char *)NULL);
+    TEST_ASSERT(null_result == SSTR_ERROR_ARGUMENT, "NULL %s argument should be rejected");
+
+    /* Output produced before the error is not left behind, and existing
+     * content is kept under either policy */
+    sstr_clear(&str);
+    TEST_ASSERT(sstr_format(&str, "abc%s", (const char *)NULL) == SSTR_ERROR_ARGUMENT,
+                "NULL %s after literal text should be rejected");
+    TEST_ASSERT(str.length == 0 && str.data[0] == '\0', "Empty string should stay empty");
+    sstr_copy(&str, "keep");
+    TEST_ASSERT(sstr_format_ex(&str, SSTR_ERROR, "abc%s", (const char *)NULL) ==
+                    SSTR_ERROR_ARGUMENT,
+                "NULL %s should be rejected under SSTR_ERROR");
+    TEST_ASSERT(str.length == 4 && strcmp(str.data, "keep") == 0,
+                "Content should be kept under SSTR_ERROR");
+    TEST_ASSERT(sstr_format_ex(&str, SSTR_TRUNCATE, "abc%s", (const char *)NULL) ==
+                    SSTR_ERROR_ARGUMENT,
+                "NULL %s should be rejected under SSTR_TRUNCATE");
+    TEST_ASSERT(str.length == 4 && strcmp(str.data, "keep") == 0,
+                "Content should be kept under SSTR_TRUNCATE");
+    TEST_ASSERT(sstr_append_format(&str, "abc%s", (const char *)NULL) == SSTR_ERROR_ARGUMENT,
+                "NULL %s should be rejected when appending");
+    TEST_ASSERT(str.length == 4 && strcmp(str.data, "keep") == 0,
+                "Content should be kept when appending");
+#endif
+
+    /* Output that exactly fills the capacity */
+    char small_buffer[6];
+    SStr small;
+    sstr_init(&small, small_buffer, sizeof(small_buffer));
+    int result = sstr_format(&small, "%d", 12345);
+    TEST_ASSERT(result == 5, "Output that exactly fits should succeed");
+    TEST_ASSERT(strcmp(small.data, "12345") == 0, "Content should be '12345'");
+
+    return 1;
+}
+
+static int test_format_program(void)
+{
+    char buffer[64];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+    SStrFormatProgram prog;
+
+    /* Compile once, execute many times */
+    SStrResult compiled = sstr_format_compile(&prog, "id=%05d name=%-4s hex=%#x%%");
+    TEST_ASSERT(compiled == SSTR_SUCCESS, "Compilation should succeed");
+
+    int result = sstr_format_exec(&str, &prog, 42, "ab", 255u);
+    TEST_ASSERT(result == (int)str.length, "Result should match the length");
+    TEST_ASSERT(strcmp(str.data, "id=00042 name=ab   hex=0xff%") == 0, "Program output incorrect");
+
+    result = sstr_format_exec(&str, &prog, -7, "wxyz", 0u);
+    TEST_ASSERT(strcmp(str.data, "id=-0007 name=wxyz hex=0%") == 0, "Second execution incorrect");
+
+    /* Literal-only and empty formats */
+    TEST_ASSERT(sstr_format_compile(&prog, "plain") == SSTR_SUCCESS, "Literal should compile");
+    result = sstr_format_exec(&str, &prog);
+    TEST_ASSERT(result == 5 && strcmp(str.data, "plain") == 0, "Literal program incorrect");
+
+    TEST_ASSERT(sstr_format_compile(&prog, "") == SSTR_SUCCESS, "Empty format should compile");
+    result = sstr_format_exec(&str, &prog);
+    TEST_ASSERT(result == 0 && str.length == 0, "Empty program should produce nothing");
+
+    /* Overflow follows the same policy as sstr_format */
+    char small_buffer[6];
+    SStr small;
+    sstr_init(&small, small_buffer, sizeof(small_buffer));
+    sstr_copy(&small, "keep");
+    TEST_ASSERT(sstr_format_compile(&prog, "%s") == SSTR_SUCCESS, "Compilation should succeed");
+    result = sstr_format_exec(&small, &prog, "too long");
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(strcmp(small.data, "keep") == 0, "Content should be unchanged after overflow");
+#endif
+
+    /* Rejected formats leave an unusable program */
+    TEST_ASSERT(sstr_format_compile(&prog, "%f") == SSTR_ERROR_FORMAT, "Float should be rejected");
+    TEST_ASSERT(sstr_format_exec(&str, &prog, 1.0) == SSTR_ERROR_FORMAT,
+                "Failed program should not execute");
+    TEST_ASSERT(sstr_format_compile(&prog, "bad %") == SSTR_ERROR_FORMAT,
+                "Incomplete format should be rejected");
+
+    /* Too many conversions for the fixed-size program */
+    char many[3 * SSTR_FORMAT_MAX_OPS + 1];
+    for (size_t i = 0; i < SSTR_FORMAT_MAX_OPS + 1; i++) {
+        memcpy(many + 2 * i, "%d", 2);
+    }
+    many[2 * (SSTR_FORMAT_MAX_OPS + 1)] = '\0';
+    TEST_ASSERT(sstr_format_compile(&prog, many) == SSTR_ERROR_OVERFLOW,
+                "Too many conversions should overflow the program");
+
+    /* NULL handling */
+    TEST_ASSERT(sstr_format_compile(NULL, "%d") == SSTR_ERROR_NULL, "Should detect NULL program");
+    TEST_ASSERT(sstr_format_compile(&prog, NULL) == SSTR_ERROR_NULL, "Should detect NULL format");
+    TEST_ASSERT(sstr_format_exec(&str, NULL) == SSTR_ERROR_NULL, "Should detect NULL program");
+
+    return 1;
+}
+
+static int test_format_literal(void)
+{
+    char buffer[64];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* Same results as sstr_format, whichever path the build selects */
+    int result = sstr_format_literal(&str, "id=%d name=%s %%", 42, "abc");
+    TEST_ASSERT(result == (int)str.length, "Result should match the length");
+    TEST_ASSERT(strcmp(str.data, "id=42 name=abc %") == 0, "Literal output incorrect");
+
+    result = sstr_format_literal(&str, "%-4d|%5s|", -1, "ab");
+    TEST_ASSERT(strcmp(str.data, "-1  |   ab|") == 0, "Width handling incorrect");
+
+    result = sstr_format_literal(&str, "no conversions");
+    TEST_ASSERT(result == 14 && strcmp(str.data, "no conversions") == 0,
+                "Plain literal incorrect");
+
+    /* Overflow follows the same policy as sstr_format */
+    char small_buffer[6];
+    SStr small;
+    sstr_init(&small, small_buffer, sizeof(small_buffer));
+    sstr_copy(&small, "keep");
+    result = sstr_format_literal(&small, "%s", "too long");
+#if SSTR_DEFAULT_POLICY == SSTR_ERROR
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Should return overflow error");
+    TEST_ASSERT(strcmp(small.data, "keep") == 0, "Content should be unchanged after overflow");
+#endif
+
+    /* The unchecked entry points still reject NULL */
+    TEST_ASSERT(sstr_format_unchecked(NULL, "%d", 1) == SSTR_ERROR_NULL,
+                "Should detect NULL destination");
+    TEST_ASSERT(sstr_format_unchecked(&str, NULL) == SSTR_ERROR_NULL, "Should detect NULL format");
+
+    return 1;
+}
+#endif
+
+static int test_append_integer(void)
+{
+    char buffer[32];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* Decimal appends after existing content */
+    sstr_copy(&str, "Value: ");
+    TEST_ASSERT(sstr_append_i64(&str, 42) == SSTR_SUCCESS, "Append i64 should succeed");
+    TEST_ASSERT(strcmp(str.data, "Value: 42") == 0, "Content should be 'Value: 42'");
+    TEST_ASSERT(str.length == 9, "Length should be 9");
+
+    /* Every digit count, around each power of ten */
+    char expected[32];
+    uint64_t power = 1;
+    for (int digits = 1; digits <= 20; digits++) {
+        uint64_t values[3];
+        values[0] = power;
+        values[1] = power - 1;
+        values[2] = power + 1;
+        for (int i = 0; i < 3; i++) {
+            sstr_clear(&str);
+            TEST_ASSERT(sstr_append_u64(&str, values[i]) == SSTR_SUCCESS,
+                        "Append u64 should succeed");
+            snprintf(expected, sizeof(expected), "%llu", (unsigned long long)values[i]);
+            TEST_ASSERT(strcmp(str.data, expected) == 0, "u64 digits should match snprintf");
+            TEST_ASSERT(str.length == strlen(expected), "u64 length should match snprintf");
+        }
+        if (digits < 20) {
+            power *= 10;
+        }
+    }
+
+    sstr_clear(&str);
+    sstr_append_u64(&str, UINT64_MAX);
+    TEST_ASSERT(strcmp(str.data, "18446744073709551615") == 0, "UINT64_MAX digits incorrect");
+
+    sstr_clear(&str);
+    sstr_append_i64(&str, INT64_MIN);
+    TEST_ASSERT(strcmp(str.data, "-9223372036854775808") == 0, "INT64_MIN digits incorrect");
+
+    sstr_clear(&str);
+    sstr_append_i64(&str, -7);
+    sstr_append_i64(&str, 0);
+    TEST_ASSERT(strcmp(str.data, "-70") == 0, "Content should be '-70'");
+
+    /* Hex with and without padding */
+    sstr_clear(&str);
+    sstr_append_hex(&str, 0xbeef, 0, 0);
+    TEST_ASSERT(strcmp(str.data, "beef") == 0, "Content should be 'beef'");
+    sstr_clear(&str);
+    sstr_append_hex(&str, 0xbeef, 8, 1);
+    TEST_ASSERT(strcmp(str.data, "0000BEEF") == 0, "Content should be '0000BEEF'");
+    sstr_clear(&str);
+    sstr_append_hex(&str, 0, 0, 0);
+    TEST_ASSERT(strcmp(str.data, "0") == 0, "Content should be '0'");
+    sstr_clear(&str);
+    sstr_append_hex(&str, UINT64_MAX, 2, 0);
+    TEST_ASSERT(strcmp(str.data, "ffffffffffffffff") == 0, "Width below digits is ignored");
+
+    /* Overflow under SSTR_ERROR leaves the content unchanged */
+    char small_buffer[6];
+    SStr small;
+    sstr_init(&small, small_buffer, sizeof(small_buffer));
+    sstr_copy(&small, "ab");
+    TEST_ASSERT(sstr_append_i64_ex(&small, -1234, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Too many digits should overflow");
+    TEST_ASSERT(strcmp(small.data, "ab") == 0 && small.length == 2,
+                "Content should be unchanged after overflow");
+    TEST_ASSERT(sstr_append_hex_ex(&small, 1, 4, 0, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Too much padding should overflow");
+    TEST_ASSERT(sstr_append_hex_ex(&small, 1, (size_t)-1, 0, SSTR_ERROR) == SSTR_ERROR_OVERFLOW,
+                "Huge padding should overflow");
+    TEST_ASSERT(sstr_append_u64_ex(&small, 123, SSTR_ERROR) == SSTR_SUCCESS,
+                "Exact fit should succeed");
+    TEST_ASSERT(strcmp(small.data, "ab123") == 0, "Content should be 'ab123'");
+
+    /* Truncation keeps the leading characters */
+    sstr_copy(&small, "ab");
+    TEST_ASSERT(sstr_append_i64_ex(&small, -98765, SSTR_TRUNCATE) == SSTR_SUCCESS,
+                "Truncating append should succeed");
+    TEST_ASSERT(strcmp(small.data, "ab-98") == 0, "Content should be 'ab-98'");
+    sstr_copy(&small, "ab");
+    sstr_append_hex_ex(&small, 0xf, (size_t)-1, 0, SSTR_TRUNCATE);
+    TEST_ASSERT(strcmp(small.data, "ab000") == 0, "Content should be 'ab000'");
+
+    /* NULL and invalid arguments */
+    TEST_ASSERT(sstr_append_i64(NULL, 1) == SSTR_ERROR_NULL, "NULL dest should fail");
+    TEST_ASSERT(sstr_append_u64_ex(&small, 1, (SStrTruncationPolicy)7) == SSTR_ERROR_ARGUMENT,
+                "Invalid policy should fail");
+
+    return 1;
+}
+
+#if SSTR_ENABLE_FORMAT
+static int test_append_format(void)
+{
+    char buffer[16];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+
+    /* Pieces accumulate after the current content */
+    sstr_copy(&str, "id=");
+    int result = sstr_append_format(&str, "%d", 42);
+    TEST_ASSERT(result == 2, "Append format result should be 2");
+    result = sstr_append_format(&str, " %s=%x", "v", 255);
+    TEST_ASSERT(result == 5, "Append format result should be 5");
+    TEST_ASSERT(strcmp(str.data, "id=42 v=ff") == 0, "Content should be 'id=42 v=ff'");
+    TEST_ASSERT(str.length == 10, "Length should be 10");
+
+    /* Appending to an empty string behaves like sstr_format */
+    sstr_clear(&str);
+    TEST_ASSERT(sstr_append_format(&str, "%c%c", 'o', 'k') == 2, "Result should be 2");
+    TEST_ASSERT(strcmp(str.data, "ok") == 0, "Content should be 'ok'");
+
+    /* Exactly filling the remaining capacity succeeds */
+    sstr_copy(&str, "0123456789");
+    TEST_ASSERT(sstr_append_format_ex(&str, SSTR_ERROR, "%s", "abcde") == 5,
+                "Exact fit should succeed");
+    TEST_ASSERT(str.length == 15, "Length should be the capacity");
+
+    /* Overflow under SSTR_ERROR leaves the content unchanged */
+    sstr_copy(&str, "0123456789");
+    result = sstr_append_format_ex(&str, SSTR_ERROR, "%s", "abcdef");
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "Overflow should be reported");
+    TEST_ASSERT(strcmp(str.data, "0123456789") == 0 && str.length == 10,
+                "Content should be unchanged after overflow");
+
+    /* Truncation fills the buffer and reports the full output length */
+    result = sstr_append_format_ex(&str, SSTR_TRUNCATE, "%s", "abcdefgh");
+    TEST_ASSERT(result == 8, "Truncated result should be the full output length");
+    TEST_ASSERT(strcmp(str.data, "0123456789abcde") == 0, "Content should be truncated");
+    TEST_ASSERT(str.length == str.capacity, "Length should be the capacity");
+
+#if SSTR_VALIDATE_FORMAT
+    /* Rejected formats leave the content unchanged */
+    sstr_copy(&str, "keep");
+    TEST_ASSERT(sstr_append_format(&str, "%p", (void *)&str) == SSTR_ERROR_FORMAT,
+                "Disallowed specifier should be rejected");
+    TEST_ASSERT(strcmp(str.data, "keep") == 0, "Content should be unchanged");
+#endif
+
+    TEST_ASSERT(sstr_append_format(NULL, "%d", 1) == SSTR_ERROR_NULL, "NULL dest should fail");
+    TEST_ASSERT(sstr_append_format(&str, NULL) == SSTR_ERROR_NULL, "NULL format should fail");
+    TEST_ASSERT(sstr_append_format_ex(&str, (SStrTruncationPolicy)7, "x") == SSTR_ERROR_ARGUMENT,
+                "Invalid policy should fail");
+
+    return 1;
+}
+#endif
+
 int run_format_tests(void)
 {
     int passed = 0;
@@ -204,6 +570,7 @@ int run_format_tests(void)
 
     printf("Running format tests...\n");
 
+#if SSTR_ENABLE_FORMAT
     total++;
     if (test_format_basic()) {
         passed++;
@@ -234,6 +601,39 @@ int run_format_tests(void)
         printf("PASS: format validation tests\n");
     }
 
+    total++;
+    if (test_format_conversions()) {
+        passed++;
+        printf("PASS: format conversion tests\n");
+    }
+
+    total++;
+    if (test_format_program()) {
+        passed++;
+        printf("PASS: format program tests\n");
+    }
+
+    total++;
+    if (test_format_literal()) {
+        passed++;
+        printf("PASS: format literal tests\n");
+    }
+#endif
+
+    total++;
+    if (test_append_integer()) {
+        passed++;
+        printf("PASS: integer append tests\n");
+    }
+
+#if SSTR_ENABLE_FORMAT
+    total++;
+    if (test_append_format()) {
+        passed++;
+        printf("PASS: append format tests\n");
+    }
+#endif
+
     printf("Format tests: %d/%d passed\n", passed, total);
     return passed == total;
 }
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+static int test_intern_basic(void)
+{
+    SStrInternSlot slots[8];
+    char pool[64];
+    SStrInternTable table;
+    SStrView a, b, c, found;
+
+    TEST_ASSERT(sstr_intern_init(&table, slots, 8, pool, sizeof(pool)) == SSTR_SUCCESS,
+                "Intern init should succeed");
+
+    /* The same content from different buffers gives the same copy */
+    char topic[16];
+    strcpy(topic, "sensors/temp");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("sensors/temp"), &a) == SSTR_SUCCESS,
+                "First intern should succeed");
+    TEST_ASSERT(sstr_intern(&table, sstr_view_from_cstr(topic), &b) == SSTR_SUCCESS,
+                "Second intern should succeed");
+    TEST_ASSERT(a.data == b.data && a.length == 12, "Equal strings should share one copy");
+    TEST_ASSERT(a.data >= pool && a.data < pool + sizeof(pool), "Copy should live in the pool");
+    TEST_ASSERT(a.data[a.length] == '\0', "Interned copy should be terminated");
+    topic[0] = 'X';
+    TEST_ASSERT(strcmp(a.data, "sensors/temp") == 0, "Copy should not depend on the source");
+
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("sensors/humidity"), &c) == SSTR_SUCCESS,
+                "Third intern should succeed");
+    TEST_ASSERT(c.data != a.data, "Different strings should get different copies");
+    TEST_ASSERT(table.count == 2 && table.pool_used == 13 + 17, "Two strings should be stored");
+
+    /* Empty strings and embedded NUL bytes are ordinary content */
+    SStrView nul = {"a\0b", 3};
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT(""), &b) == SSTR_SUCCESS && b.length == 0,
+                "Empty string should intern");
+    TEST_ASSERT(sstr_intern(&table, nul, &b) == SSTR_SUCCESS && b.length == 3 &&
+                    memcmp(b.data, "a\0b", 3) == 0,
+                "Embedded NUL should intern");
+
+    /* Lookup does not insert */
+    TEST_ASSERT(sstr_intern_find(&table, SSTR_VIEW_LIT("sensors/temp"), &found) == 1 &&
+                    found.data == a.data,
+                "Find should return the interned copy");
+    TEST_ASSERT(sstr_intern_find(&table, SSTR_VIEW_LIT("sensors"), &found) == 0,
+                "Find should miss absent strings");
+    TEST_ASSERT(table.count == 4, "Find should not add strings");
+
+    /* Reset empties the table */
+    TEST_ASSERT(sstr_intern_reset(&table) == SSTR_SUCCESS, "Reset should succeed");
+    TEST_ASSERT(table.count == 0 && table.pool_used == 0, "Reset should free everything");
+    TEST_ASSERT(sstr_intern_find(&table, SSTR_VIEW_LIT("sensors/temp"), &found) == 0,
+                "Reset table should be empty");
+
+    /* A seeded table indexes by the seeded hash */
+    uint64_t seed = UINT64_C(0x9e3779b97f4a7c15);
+    TEST_ASSERT(sstr_intern_init_seed(&table, slots, 8, pool, sizeof(pool), seed) ==
+                    SSTR_SUCCESS,
+                "Seeded init should succeed");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("sensors/temp"), &a) == SSTR_SUCCESS,
+                "Seeded intern should succeed");
+    TEST_ASSERT(sstr_intern_find(&table, SSTR_VIEW_LIT("sensors/temp"), &found) == 1 &&
+                    found.data == a.data,
+                "Seeded find should return the interned copy");
+    uint32_t hash = (uint32_t)sstr_view_hash_seed(SSTR_VIEW_LIT("sensors/temp"), seed);
+    TEST_ASSERT(slots[hash & 7].hash == hash, "Index should use the seeded hash");
+
+    /* Errors */
+    SStrView null_view = {NULL, 0};
+    TEST_ASSERT(sstr_intern_init(&table, slots, 6, pool, sizeof(pool)) == SSTR_ERROR_ARGUMENT,
+                "Slot count should be a power of two");
+    TEST_ASSERT(sstr_intern_init(&table, NULL, 8, pool, sizeof(pool)) == SSTR_ERROR_NULL,
+                "NULL slots should be rejected");
+    TEST_ASSERT(sstr_intern(&table, null_view, &a) == SSTR_ERROR_NULL,
+                "NULL view should be rejected");
+    TEST_ASSERT(sstr_intern(NULL, nul, &a) == SSTR_ERROR_NULL, "NULL table should be rejected");
+    TEST_ASSERT(sstr_intern_find(NULL, nul, &a) == 0, "NULL table should find nothing");
+
+    return 1;
+}
+
+static int test_intern_full(void)
+{
+    SStrInternSlot slots[16];
+    char pool[256];
+    SStrInternTable table;
+    SStrView views[16];
+    char name[16];
+
+    /* Sixteen slots hold twelve strings, keeping probes short */
+    sstr_intern_init(&table, slots, 16, pool, sizeof(pool));
+    for (int i = 0; i < 12; i++) {
+        snprintf(name, sizeof(name), "k%d", i);
+        TEST_ASSERT(sstr_intern(&table, sstr_view_from_cstr(name), &views[i]) == SSTR_SUCCESS,
+                    "Intern within the limit should succeed");
+    }
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("k12"), &views[12]) == SSTR_ERROR_OVERFLOW,
+                "Full index should reject new strings");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("k3"), &views[13]) == SSTR_SUCCESS &&
+                    views[13].data == views[3].data,
+                "Full index should still return existing strings");
+    for (int i = 0; i < 12; i++) {
+        snprintf(name, sizeof(name), "k%d", i);
+        TEST_ASSERT(strcmp(views[i].data, name) == 0, "Earlier copies should be stable");
+    }
+
+    /* The pool fills exactly: "abc" takes four bytes */
+    char small_pool[8];
+    sstr_intern_init(&table, slots, 16, small_pool, sizeof(small_pool));
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("abc"), &views[0]) == SSTR_SUCCESS,
+                "First string should fit");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("defg"), &views[1]) == SSTR_ERROR_OVERFLOW,
+                "String past the pool should fail");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("def"), &views[1]) == SSTR_SUCCESS,
+                "Exact fit should succeed");
+    TEST_ASSERT(table.pool_used == sizeof(small_pool), "Pool should be full");
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT(""), &views[2]) == SSTR_ERROR_OVERFLOW,
+                "Full pool should reject even an empty string");
+    TEST_ASSERT(table.count == 2, "Failed interns should not be counted");
+
+    /* One slot leaves no room, as the index always keeps a free slot */
+    sstr_intern_init(&table, slots, 1, pool, sizeof(pool));
+    TEST_ASSERT(sstr_intern(&table, SSTR_VIEW_LIT("a"), &views[0]) == SSTR_ERROR_OVERFLOW,
+                "Single slot table should be full");
+    TEST_ASSERT(sstr_intern_find(&table, SSTR_VIEW_LIT("a"), &views[0]) == 0,
+                "Lookup in a full table should terminate");
+
+    return 1;
+}
+
+int run_intern_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running intern tests...\n");
+
+    total++;
+    if (test_intern_basic()) {
+        passed++;
+        printf("PASS: intern tests\n");
+    }
+
+    total++;
+    if (test_intern_full()) {
+        passed++;
+        printf("PASS: full intern table tests\n");
+    }
+
+    printf("Intern tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+static int test_parse_decimal(void)
+{
+    int64_t i = 0;
+    uint64_t u = 0;
+    size_t used = 0;
+
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("42"), &i, NULL) == SSTR_SUCCESS && i == 42,
+                "Plain number should parse");
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("-17"), &i, NULL) == SSTR_SUCCESS && i == -17,
+                "Negative number should parse");
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("+0"), &i, NULL) == SSTR_SUCCESS && i == 0,
+                "Explicit plus should parse");
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("000000000000000000000000000123"), &u, NULL) ==
+                        SSTR_SUCCESS &&
+                    u == 123,
+                "Leading zeros should not overflow");
+
+    /* Limits and one past them */
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("9223372036854775807"), &i, NULL) == SSTR_SUCCESS &&
+                    i == INT64_MAX,
+                "INT64_MAX should parse");
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("-9223372036854775808"), &i, NULL) == SSTR_SUCCESS &&
+                    i == INT64_MIN,
+                "INT64_MIN should parse");
+    i = 7;
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("9223372036854775808"), &i, &used) ==
+                    SSTR_ERROR_OVERFLOW,
+                "INT64_MAX + 1 should overflow");
+    TEST_ASSERT(i == 7 && used == 19, "Overflow should keep out and consume the digits");
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("-9223372036854775809"), &i, NULL) ==
+                    SSTR_ERROR_OVERFLOW,
+                "INT64_MIN - 1 should overflow");
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("18446744073709551615"), &u, NULL) == SSTR_SUCCESS &&
+                    u == UINT64_MAX,
+                "UINT64_MAX should parse");
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("18446744073709551616"), &u, NULL) ==
+                    SSTR_ERROR_OVERFLOW,
+                "UINT64_MAX + 1 should overflow");
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("99999999999999999999999"), &u, NULL) ==
+                    SSTR_ERROR_OVERFLOW,
+                "Long number should overflow");
+
+    /* Prefix parsing stops at the first non-digit */
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("12345678901,rest"), &i, &used) == SSTR_SUCCESS &&
+                    i == 12345678901 && used == 11,
+                "Prefix should parse up to the comma");
+    TEST_ASSERT(sstr_parse_i64(SSTR_VIEW_LIT("12345678901,rest"), &i, NULL) == SSTR_ERROR_FORMAT,
+                "Trailing text should fail without consumed");
+    SStrView bounded = {"12345", 3};
+    TEST_ASSERT(sstr_parse_u64(bounded, &u, NULL) == SSTR_SUCCESS && u == 123,
+                "Parsing should stop at the view length");
+
+    /* No number */
+    static const char *invalid[] = {"", "-", "+", " 1", "x1", "--1", "+-1"};
+    for (size_t k = 0; k < sizeof(invalid) / sizeof(invalid[0]); k++) {
+        used = 99;
+        TEST_ASSERT(sstr_parse_i64(sstr_view_from_cstr(invalid[k]), &i, &used) ==
+                        SSTR_ERROR_FORMAT,
+                    "Invalid input should fail");
+        TEST_ASSERT(used == 0, "Invalid input should consume nothing");
+    }
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("-1"), &u, NULL) == SSTR_ERROR_FORMAT,
+                "Unsigned parse should reject a minus sign");
+
+    /* Every length and a non-digit at every position, against a reference */
+    char text[40];
+    for (size_t len = 1; len <= 20; len++) {
+        for (size_t stop = 0; stop <= len; stop++) {
+            uint64_t expected = 0;
+            for (size_t k = 0; k < len; k++) {
+                text[k] = (char)('1' + (k * 7 + len) % 9);
+            }
+            if (stop < len) {
+                text[stop] = (char)(stop % 2 ? ':' : '/'); /* Next to the digits */
+            }
+            for (size_t k = 0; k < len && k < stop; k++) {
+                expected = expected * 10 + (uint64_t)(text[k] - '0');
+            }
+            SStrView v = {text, len};
+            SStrResult result = sstr_parse_u64(v, &u, &used);
+            if (stop == 0) {
+                TEST_ASSERT(result == SSTR_ERROR_FORMAT, "Leading non-digit should fail");
+            } else if (stop < 20) {
+                TEST_ASSERT(result == SSTR_SUCCESS && u == expected && used == stop,
+                            "Prefix should match the reference");
+            }
+        }
+    }
+
+    SStrView null_view = {NULL, 0};
+    TEST_ASSERT(sstr_parse_i64(null_view, &i, NULL) == SSTR_ERROR_NULL, "NULL view should fail");
+    TEST_ASSERT(sstr_parse_u64(SSTR_VIEW_LIT("1"), NULL, NULL) == SSTR_ERROR_NULL,
+                "NULL output should fail");
+
+    return 1;
+}
+
+static int test_parse_hex(void)
+{
+    uint64_t u = 0;
+    size_t used = 0;
+
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("ff"), &u, NULL) == SSTR_SUCCESS && u == 0xff,
+                "Lower-case hex should parse");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("0xDeadBeef"), &u, NULL) == SSTR_SUCCESS &&
+                    u == 0xdeadbeef,
+                "Prefixed mixed-case hex should parse");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("0XFFFFFFFFFFFFFFFF"), &u, NULL) == SSTR_SUCCESS &&
+                    u == UINT64_MAX,
+                "Sixteen digits should parse");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("00000000000000000001"), &u, NULL) == SSTR_SUCCESS &&
+                    u == 1,
+                "Leading zeros should not overflow");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("10000000000000000"), &u, &used) ==
+                        SSTR_ERROR_OVERFLOW &&
+                    used == 17,
+                "Seventeen significant digits should overflow");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("1fg"), &u, &used) == SSTR_SUCCESS && u == 0x1f &&
+                    used == 2,
+                "Parsing should stop at a non-hex digit");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("0x"), &u, &used) == SSTR_SUCCESS && u == 0 &&
+                    used == 1,
+                "Bare prefix should parse as 0");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("0x"), &u, NULL) == SSTR_ERROR_FORMAT,
+                "Bare prefix should not be a whole number");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("g"), &u, &used) == SSTR_ERROR_FORMAT && used == 0,
+                "Non-hex input should fail");
+    TEST_ASSERT(sstr_parse_hex(SSTR_VIEW_LIT("@`GgFf"), &u, NULL) == SSTR_ERROR_FORMAT,
+                "Bytes next to the hex letters should not be digits");
+
+    /* Split fields parse in place */
+    SStrSplitIter it;
+    SStrView field;
+    uint64_t sum = 0;
+    sstr_split_init(&it, SSTR_VIEW_LIT("1a,2b,3c"), ',');
+    while (sstr_split_next(&it, &field)) {
+        TEST_ASSERT(sstr_parse_hex(field, &u, NULL) == SSTR_SUCCESS, "Field should parse");
+        sum += u;
+    }
+    TEST_ASSERT(sum == 0x1a + 0x2b + 0x3c, "Field values should add up");
+
+    return 1;
+}
+
+int run_parse_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running parse tests...\n");
+
+    total++;
+    if (test_parse_decimal()) {
+        passed++;
+        printf("PASS: decimal parse tests\n");
+    }
+
+    total++;
+    if (test_parse_hex()) {
+        passed++;
+        printf("PASS: hex parse tests\n");
+    }
+
+    printf("Parse tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -13,6 +13,13 @@
 /* Test function declarations */
 extern int run_core_tests(void);
 extern int run_format_tests(void);
+extern int run_arena_tests(void);
+extern int run_search_tests(void);
+extern int run_intern_tests(void);
+extern int run_parse_tests(void);
+extern int run_sink_tests(void);
+extern int run_chain_tests(void);
+extern int run_encode_tests(void);
 
 int main(void)
 {
@@ -39,6 +46,75 @@ int main(void)
         printf("Some format tests failed\n");
     }
 
+    printf("\n");
+
+    /* Run arena tests */
+    total++;
+    if (run_arena_tests()) {
+        passed++;
+    } else {
+        printf("Some arena tests failed\n");
+    }
+
+    printf("\n");
+
+    /* Run search tests */
+    total++;
+    if (run_search_tests()) {
+        passed++;
+    } else {
+        printf("Some search tests failed\n");
+    }
+
+    printf("\n");
+
+    /* Run intern tests */
+    total++;
+    if (run_intern_tests()) {
+        passed++;
+    } else {
+        printf("Some intern tests failed\n");
+    }
+
+    printf("\n");
+
+    /* Run parse tests */
+    total++;
+    if (run_parse_tests()) {
+        passed++;
+    } else {
+        printf("Some parse tests failed\n");
+    }
+
+    printf("\n");
+
+    /* Run sink tests */
+    total++;
+    if (run_sink_tests()) {
+        passed++;
+    } else {
+        printf("Some sink tests failed\n");
+    }
+
+    printf("\n");
+
+    /* Run chain tests */
+    total++;
+    if (run_chain_tests()) {
+        passed++;
+    } else {
+        printf("Some chain tests failed\n");
+    }
+    printf("\n");
+
+    /* Run encode tests */
+    total++;
+    if (run_encode_tests()) {
+        passed++;
+    } else {
+        printf("Some encode tests failed\n");
+    }
+
     printf("\n=== Test Summary ===\n");
     printf("Passed: %d/%d test groups\n", passed, total);
 
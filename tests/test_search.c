@@ -0,0 +1,279 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+/* Byte-by-byte references for the searches */
+static size_t naive_find(const char *hay, size_t hay_len, const char *needle, size_t n)
+{
+    for (size_t i = 0; i + n <= hay_len; i++) {
+        if (memcmp(hay + i, needle, n) == 0) {
+            return i;
+        }
+    }
+    return SSTR_NPOS;
+}
+
+static size_t naive_rfind(const char *hay, size_t hay_len, const char *needle, size_t n)
+{
+    for (size_t i = hay_len + 1; i-- > 0;) {
+        if (i + n <= hay_len && memcmp(hay + i, needle, n) == 0) {
+            return i;
+        }
+    }
+    return SSTR_NPOS;
+}
+
+static int test_find_basic(void)
+{
+    char buffer[64];
+    SStr str;
+    sstr_init(&str, buffer, sizeof(buffer));
+    sstr_copy(&str, "GET /index.html HTTP/1.1");
+
+    TEST_ASSERT(sstr_find_char(&str, ' ') == 3, "First space should be at 3");
+    TEST_ASSERT(sstr_rfind_char(&str, ' ') == 15, "Last space should be at 15");
+    TEST_ASSERT(sstr_find_char(&str, '?') == SSTR_NPOS, "Absent character should not match");
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("HTTP/")) == 16, "Substring should be at 16");
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("/")) == 4, "First slash should be at 4");
+    TEST_ASSERT(sstr_rfind(&str, SSTR_VIEW_LIT("/")) == 20, "Last slash should be at 20");
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("HTTP/2")) == SSTR_NPOS,
+                "Absent substring should not match");
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("GET /index.html HTTP/1.1!")) == SSTR_NPOS,
+                "Needle longer than the string should not match");
+
+    /* Empty needles match at either end */
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("")) == 0, "Empty needle should match at 0");
+    TEST_ASSERT(sstr_rfind(&str, SSTR_VIEW_LIT("")) == str.length,
+                "Empty needle should match at the end in reverse");
+
+    /* The search is bounded by length, not the terminator */
+    str.data[3] = '\0';
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("HTTP")) == 16, "Search should pass embedded NUL");
+    TEST_ASSERT(sstr_find_char(&str, '\0') == 3, "NUL should be searchable");
+    str.length = 10;
+    TEST_ASSERT(sstr_find(&str, SSTR_VIEW_LIT("HTTP")) == SSTR_NPOS,
+                "Search should stop at the length");
+    TEST_ASSERT(sstr_rfind_char(&str, ' ') == SSTR_NPOS, "Reverse search should stop too");
+
+    /* Views and NULL arguments */
+    SStrView view = SSTR_VIEW_LIT("a,b,,c");
+    TEST_ASSERT(sstr_view_find_char(view, ',') == 1, "View search should work");
+    TEST_ASSERT(sstr_view_rfind(view, SSTR_VIEW_LIT(",,")) == 3, "View rfind should work");
+    TEST_ASSERT(sstr_find_char(NULL, 'a') == SSTR_NPOS, "NULL string should not match");
+    TEST_ASSERT(sstr_find(NULL, SSTR_VIEW_LIT("")) == SSTR_NPOS, "NULL string should not match");
+    SStrView null_view = {NULL, 0};
+    TEST_ASSERT(sstr_view_find(view, null_view) == SSTR_NPOS, "NULL needle should not match");
+
+    return 1;
+}
+
+static int test_find_blocks(void)
+{
+    /* Matches at every position and alignment, across block boundaries */
+    static const char *needles[] = {"x", "xy", "xyz", "xaax", "xaaaaaaaaaaaaaaaaaaaaaaaaaaaaaax"};
+    char hay[200];
+
+    for (size_t offset = 0; offset < 32; offset++) {
+        for (size_t len = 0; len < 140; len += (len < 40 ? 1 : 7)) {
+            for (size_t k = 0; k < sizeof(needles) / sizeof(needles[0]); k++) {
+                const char *needle = needles[k];
+                size_t n = strlen(needle);
+                SStrView nv = {needle, n};
+
+                for (size_t pos = 0; pos <= len; pos += (len < 40 ? 1 : 5)) {
+                    memset(hay, 'a', sizeof(hay));
+                    char *h = hay + offset;
+                    /* Bait: first and last bytes present without a match */
+                    if (len > 2) {
+                        h[len / 2] = 'x';
+                    }
+                    if (pos + n <= len) {
+                        memcpy(h + pos, needle, n);
+                    }
+                    SStrView hv = {h, len};
+
+                    TEST_ASSERT(sstr_view_find(hv, nv) == naive_find(h, len, needle, n),
+                                "Find should match the reference");
+                    TEST_ASSERT(sstr_view_rfind(hv, nv) == naive_rfind(h, len, needle, n),
+                                "Rfind should match the reference");
+                    TEST_ASSERT(sstr_view_find_char(hv, needle[n - 1]) ==
+                                    naive_find(h, len, needle + n - 1, 1),
+                                "Find char should match the reference");
+                    TEST_ASSERT(sstr_view_rfind_char(hv, needle[0]) ==
+                                    naive_rfind(h, len, needle, 1),
+                                "Rfind char should match the reference");
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+static int test_split_basic(void)
+{
+    static const char config[] = "mode=fast;; retries=3;";
+    char before[sizeof(config)];
+    SStrView source = {config, sizeof(config) - 1};
+    SStrSplitIter it;
+    SStrView token;
+
+    memcpy(before, config, sizeof(config));
+
+    /* Empty tokens are kept, including the trailing one */
+    static const char *expected[] = {"mode=fast", "", " retries=3", ""};
+    TEST_ASSERT(sstr_split_init(&it, source, ';') == SSTR_SUCCESS, "Split init should succeed");
+    for (size_t k = 0; k < sizeof(expected) / sizeof(expected[0]); k++) {
+        TEST_ASSERT(sstr_split_next(&it, &token) == 1, "Split should yield a token");
+        TEST_ASSERT(sstr_view_equals(token, sstr_view_from_cstr(expected[k])),
+                    "Token should match the expected text");
+    }
+    TEST_ASSERT(sstr_split_next(&it, &token) == 0, "Split should be exhausted");
+    TEST_ASSERT(sstr_split_next(&it, &token) == 0, "Split should stay exhausted");
+    TEST_ASSERT(memcmp(config, before, sizeof(config)) == 0, "Split must not modify the source");
+
+    /* Tokens point into the source */
+    sstr_split_init_set(&it, source, SSTR_VIEW_LIT("=; "));
+    sstr_split_next(&it, &token);
+    sstr_split_next(&it, &token);
+    TEST_ASSERT(token.data == config + 5 && token.length == 4, "Token should be a view of fast");
+
+    /* Iterators are independent, so splits can nest */
+    SStrSplitIter outer, inner;
+    SStrView field, part;
+    size_t parts = 0;
+    sstr_split_init(&outer, SSTR_VIEW_LIT("a=1,b=2"), ',');
+    while (sstr_split_next(&outer, &field)) {
+        sstr_split_init(&inner, field, '=');
+        while (sstr_split_next(&inner, &part)) {
+            parts++;
+        }
+    }
+    TEST_ASSERT(parts == 4, "Nested splits should yield four parts");
+
+    /* An empty source is one empty token, as is an empty delimiter set */
+    sstr_split_init(&it, SSTR_VIEW_LIT(""), ',');
+    TEST_ASSERT(sstr_split_next(&it, &token) == 1 && token.length == 0,
+                "Empty source should yield one empty token");
+    TEST_ASSERT(sstr_split_next(&it, &token) == 0, "Empty source should yield one token");
+    sstr_split_init_set(&it, SSTR_VIEW_LIT("a,b"), SSTR_VIEW_LIT(""));
+    TEST_ASSERT(sstr_split_next(&it, &token) == 1 && token.length == 3,
+                "Empty set should yield the whole source");
+
+    /* NUL is an ordinary delimiter */
+    static const char nul_separated[] = "k\0v";
+    SStrView nul_source = {nul_separated, 3};
+    sstr_split_init(&it, nul_source, '\0');
+    sstr_split_next(&it, &token);
+    TEST_ASSERT(token.length == 1 && token.data[0] == 'k', "NUL should split off k");
+    sstr_split_next(&it, &token);
+    TEST_ASSERT(token.length == 1 && token.data[0] == 'v', "NUL should split off v");
+
+    /* Errors */
+    SStrView null_view = {NULL, 0};
+    TEST_ASSERT(sstr_split_init(NULL, nul_source, ',') == SSTR_ERROR_NULL,
+                "NULL iterator should be rejected");
+    TEST_ASSERT(sstr_split_init(&it, null_view, ',') == SSTR_ERROR_NULL,
+                "NULL source should be rejected");
+    TEST_ASSERT(sstr_split_next(NULL, &token) == 0, "NULL iterator should yield nothing");
+
+    return 1;
+}
+
+static int test_split_blocks(void)
+{
+    /* Sets below, at and above SSTR_SPLIT_SET_MAX distinct bytes */
+    static const char *sets[] = {",", ",;", ",;,;", ";:,.!?-_", ";:,.!?-_/", "\x80\xff,"};
+    char source[200];
+
+    for (size_t k = 0; k < sizeof(sets) / sizeof(sets[0]); k++) {
+        SStrView set = sstr_view_from_cstr(sets[k]);
+
+        for (size_t offset = 0; offset < 32; offset++) {
+            for (size_t len = 0; len < 150; len += (len < 40 ? 1 : 9)) {
+                char *src = source + offset;
+
+                /* Delimiters at a varying spacing, cycling through the set */
+                memset(source, 'a', sizeof(source));
+                for (size_t i = len / 3, j = 0; i < len; i += 1 + (i % 23), j++) {
+                    src[i] = set.data[j % set.length];
+                }
+
+                SStrSplitIter it;
+                SStrView token;
+                SStrView sv = {src, len};
+                size_t start = 0;
+                TEST_ASSERT(sstr_split_init_set(&it, sv, set) == SSTR_SUCCESS,
+                            "Split init should succeed");
+
+                for (size_t i = 0; i <= len; i++) {
+                    if (i < len && memchr(set.data, src[i], set.length) == NULL) {
+                        continue;
+                    }
+                    TEST_ASSERT(sstr_split_next(&it, &token) == 1, "Split should yield a token");
+                    TEST_ASSERT(token.data == src + start && token.length == i - start,
+                                "Token should match the reference");
+                    start = i + 1;
+                }
+                TEST_ASSERT(sstr_split_next(&it, &token) == 0, "Split should be exhausted");
+            }
+        }
+    }
+
+    return 1;
+}
+
+int run_search_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running search tests...\n");
+
+    total++;
+    if (test_find_basic()) {
+        passed++;
+        printf("PASS: basic search tests\n");
+    }
+
+    total++;
+    if (test_find_blocks()) {
+        passed++;
+        printf("PASS: block search tests\n");
+    }
+
+    total++;
+    if (test_split_basic()) {
+        passed++;
+        printf("PASS: basic split tests\n");
+    }
+
+    total++;
+    if (test_split_blocks()) {
+        passed++;
+        printf("PASS: block split tests\n");
+    }
+
+    printf("Search tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -82,6 +82,7 @@ void test_copy_and_append(void)
     printf("Copy and append tests passed\n");
 }
 
+#if SSTR_ENABLE_FORMAT
 void test_formatting(void)
 {
     char buffer[BUFFER_SIZE];
@@ -111,6 +112,7 @@ void test_formatting(void)
 
     printf("Formatting tests passed\n");
 }
+#endif
 
 int main(void)
 {
@@ -118,7 +120,9 @@ int main(void)
 
     test_initialization();
     test_copy_and_append();
+#if SSTR_ENABLE_FORMAT
     test_formatting();
+#endif
 
     printf("All single-include tests passed!\n");
     return 0;
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at
+ * https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ASSERT(condition, message)                                                            \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            printf("FAIL: %s (%s, line %d)\n", message, __FILE__, __LINE__);                       \
+            return 0;                                                                              \
+        }                                                                                          \
+    } while (0)
+
+/* Collects everything flushed, standing in for a UART or socket */
+typedef struct {
+    char data[512];
+    size_t length;
+    size_t calls;
+    size_t batches[64]; /* Length of each flush */
+    int fail;           /* Reject flushes while set */
+} Capture;
+
+static SStrResult capture_flush(void *context, const char *data, size_t length)
+{
+    Capture *capture = (Capture *)context;
+
+    if (capture->fail || capture->length + length > sizeof(capture->data)) {
+        return SSTR_ERROR_OVERFLOW;
+    }
+
+    memcpy(capture->data + capture->length, data, length);
+    capture->length += length;
+    if (capture->calls < sizeof(capture->batches) / sizeof(capture->batches[0])) {
+        capture->batches[capture->calls] = length;
+    }
+    capture->calls++;
+
+    return SSTR_SUCCESS;
+}
+
+static int test_sink_write(void)
+{
+    char buffer[16];
+    Capture capture;
+    SStrSink sink;
+
+    memset(&capture, 0, sizeof(capture));
+    TEST_ASSERT(sstr_sink_init(&sink, buffer, sizeof(buffer), capture_flush, &capture) ==
+                    SSTR_SUCCESS,
+                "Sink init should succeed");
+    TEST_ASSERT(sink.buffer.capacity == 15, "Sink should buffer size - 1 bytes");
+
+    /* Writes that fit are batched without a flush */
+    TEST_ASSERT(sstr_sink_append(&sink, "hello ") == SSTR_SUCCESS, "Append should succeed");
+    TEST_ASSERT(sstr_sink_append_view(&sink, SSTR_VIEW_LIT("world")) == SSTR_SUCCESS,
+                "Append view should succeed");
+    TEST_ASSERT(capture.calls == 0, "Nothing should be flushed while the buffer has room");
+    TEST_ASSERT(strcmp(sink.buffer.data, "hello world") == 0, "Buffer should hold the writes");
+
+    /* A write that does not fit flushes the buffered bytes first */
+    TEST_ASSERT(sstr_sink_append(&sink, ", again") == SSTR_SUCCESS,
+                "Overflowing append should flush");
+    TEST_ASSERT(capture.calls == 1 && capture.batches[0] == 11, "Buffered bytes should flush");
+    TEST_ASSERT(strcmp(sink.buffer.data, ", again") == 0, "The new write should be buffered");
+
+    /* A write as large as the buffer goes straight to the callback */
+    TEST_ASSERT(sstr_sink_append(&sink, "0123456789abcdefghij") == SSTR_SUCCESS,
+                "Large append should succeed");
+    TEST_ASSERT(capture.calls == 3 && capture.batches[1] == 7 && capture.batches[2] == 20,
+                "Large write should be handed over in place");
+    TEST_ASSERT(sink.buffer.length == 0, "Buffer should be empty after a large write");
+
+    /* Flushing an empty buffer calls nothing */
+    TEST_ASSERT(sstr_sink_flush(&sink) == SSTR_SUCCESS, "Empty flush should succeed");
+    TEST_ASSERT(capture.calls == 3, "Empty flush should not call the callback");
+
+    TEST_ASSERT(sstr_sink_write(&sink, "x\0y", 3) == SSTR_SUCCESS, "Write should keep NUL");
+    TEST_ASSERT(sstr_sink_flush(&sink) == SSTR_SUCCESS, "Flush should succeed");
+    TEST_ASSERT(capture.length == 41 && sink.flushed == 41, "Every byte should be flushed");
+    TEST_ASSERT(memcmp(capture.data, "hello world, again0123456789abcdefghijx\0y", 41) == 0,
+                "Output should arrive in order");
+
+    /* A failed flush keeps the buffered bytes and drops the write */
+    capture.fail = 1;
+    TEST_ASSERT(sstr_sink_append(&sink, "pending") == SSTR_SUCCESS, "Buffered append succeeds");
+    TEST_ASSERT(sstr_sink_append(&sink, " overflow") == SSTR_ERROR_OVERFLOW,
+                "Failing flush should be reported");
+    TEST_ASSERT(strcmp(sink.buffer.data, "pending") == 0, "Buffered bytes should be kept");
+    TEST_ASSERT(sstr_sink_flush(&sink) == SSTR_ERROR_OVERFLOW, "Failing flush should fail");
+    capture.fail = 0;
+    TEST_ASSERT(sstr_sink_flush(&sink) == SSTR_SUCCESS, "Retried flush should succeed");
+    TEST_ASSERT(capture.length == 48 && sink.flushed == 48, "Retried flush should deliver");
+
+    /* Argument errors */
+    TEST_ASSERT(sstr_sink_init(&sink, buffer, 1, capture_flush, &capture) ==
+                    SSTR_ERROR_OVERFLOW,
+                "A one-byte buffer holds nothing");
+    TEST_ASSERT(sstr_sink_init(&sink, buffer, sizeof(buffer), NULL, NULL) == SSTR_ERROR_NULL,
+                "Missing callback should fail");
+    TEST_ASSERT(sstr_sink_write(NULL, "a", 1) == SSTR_ERROR_NULL, "NULL sink should fail");
+    TEST_ASSERT(sstr_sink_append(&sink, NULL) == SSTR_ERROR_NULL, "NULL source should fail");
+
+    return 1;
+}
+
+#if SSTR_ENABLE_FORMAT
+static int test_sink_format(void)
+{
+    char buffer[16];
+    char expected[256];
+    Capture capture;
+    SStrSink sink;
+
+    memset(&capture, 0, sizeof(capture));
+    sstr_sink_init(&sink, buffer, sizeof(buffer), capture_flush, &capture);
+
+    /* Output that fits behind the buffered bytes */
+    TEST_ASSERT(sstr_sink_format(&sink, "id=%d ", 42) == 6, "Small format should succeed");
+    TEST_ASSERT(capture.calls == 0, "Small format should not flush");
+
+    /* Output that only fits an empty buffer flushes and formats again */
+    TEST_ASSERT(sstr_sink_format(&sink, "temp=%u.%02u", 21u, 5u) == 10,
+                "Format should succeed after a flush");
+    TEST_ASSERT(capture.calls == 1 && capture.batches[0] == 6, "Buffered bytes should flush");
+    TEST_ASSERT(strcmp(sink.buffer.data, "temp=21.05") == 0, "Output should be buffered");
+
+    /* Output longer than the whole buffer is streamed through it */
+    const char *payload = "The quick brown fox jumps over the lazy dog";
+    int result = sstr_sink_format(&sink, " [%s] %-40d|%08x", payload, -7, 0xbeefu);
+#if SSTR_NATIVE_FORMAT
+    int length = snprintf(expected, sizeof(expected), "temp=21.05 [%s] %-40d|%08x", payload, -7,
+                          0xbeefu);
+    TEST_ASSERT(result == length - 10, "Streamed format should return its full length");
+    TEST_ASSERT(sstr_sink_flush(&sink) == SSTR_SUCCESS, "Flush should succeed");
+    TEST_ASSERT(capture.length == 6 + (size_t)length, "Every character should arrive");
+    TEST_ASSERT(memcmp(capture.data + 6, expected, (size_t)length) == 0,
+                "Streamed output should match snprintf");
+
+    /* Padding is batched a full buffer at a time */
+    capture.length = 0;
+    capture.calls = 0;
+    TEST_ASSERT(sstr_sink_format(&sink, "%50s", "") == 50, "Wide padding should stream");
+    TEST_ASSERT(capture.calls == 3 && capture.batches[0] == 15 && capture.batches[2] == 15,
+                "Padding should flush in full batches");
+    TEST_ASSERT(sink.buffer.length == 5, "The remainder should stay buffered");
+#else
+    (void)expected;
+    TEST_ASSERT(result == SSTR_ERROR_OVERFLOW, "libc engine cannot stream large output");
+    TEST_ASSERT(capture.length == 16 && sink.buffer.length == 0,
+                "Buffered bytes should still be flushed");
+#endif
+
+    /* A failing flush rejects output that does not fit */
+    sstr_sink_init(&sink, buffer, sizeof(buffer), capture_flush, &capture);
+    sstr_sink_append(&sink, "buffered");
+    capture.fail = 1;
+    TEST_ASSERT(sstr_sink_format(&sink, "%s", "does not fit") == SSTR_ERROR_OVERFLOW,
+                "Flush error should be returned");
+    TEST_ASSERT(strcmp(sink.buffer.data, "buffered") == 0, "Buffer should be unchanged");
+    capture.fail = 0;
+
+#if SSTR_VALIDATE_FORMAT
+    TEST_ASSERT(sstr_sink_format(&sink, "%f", 1.0) == SSTR_ERROR_FORMAT,
+                "Format validation should apply");
+#endif
+    TEST_ASSERT(sstr_sink_format(NULL, "x") == SSTR_ERROR_NULL, "NULL sink should fail");
+
+    return 1;
+}
+#endif
+
+int run_sink_tests(void)
+{
+    int passed = 0;
+    int total = 0;
+
+    printf("Running sink tests...\n");
+
+    total++;
+    if (test_sink_write()) {
+        passed++;
+        printf("PASS: sink write tests\n");
+    }
+
+#if SSTR_ENABLE_FORMAT
+    total++;
+    if (test_sink_format()) {
+        passed++;
+        printf("PASS: sink format tests\n");
+    }
+#endif
+
+    printf("Sink tests: %d/%d passed\n", passed, total);
+    return passed == total;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * CBMC Verification Harness for the native sstr_format engine
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+#include <stdlib.h>
+
+#ifndef SSTR_ERROR
+#define SSTR_ERROR 0
+#endif
+
+#ifndef SSTR_TRUNCATE
+#define SSTR_TRUNCATE 1
+#endif
+
+#ifndef SSTR_DEFAULT_POLICY
+#define SSTR_DEFAULT_POLICY SSTR_ERROR
+#endif
+
+/* Number of decimal characters needed for value, including the sign */
+static size_t decimal_length(int value) {
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    size_t len = value < 0 ? 2 : 1;
+
+    /* Unroll the loop explicitly for CBMC */
+    if (magnitude >= 10u) { len++; }
+    if (magnitude >= 100u) { len++; }
+    if (magnitude >= 1000u) { len++; }
+    if (magnitude >= 10000u) { len++; }
+    if (magnitude >= 100000u) { len++; }
+    if (magnitude >= 1000000u) { len++; }
+    if (magnitude >= 10000000u) { len++; }
+    if (magnitude >= 100000000u) { len++; }
+    if (magnitude >= 1000000000u) { len++; }
+
+    return len;
+}
+
+/* CBMC verification harness */
+void sstr_format_harness() {
+    /* Create a small buffer for the destination string */
+    const size_t DEST_SIZE = 8;
+    char dest_buffer[DEST_SIZE];
+    SStr dest;
+
+    /* Initialize the destination string */
+    sstr_init(&dest, dest_buffer, DEST_SIZE);
+
+    /* Any int value, including INT_MIN */
+    int value;
+    size_t expected_len = decimal_length(value);
+
+    /* Call the function under test */
+    int result = sstr_format(&dest, "%d", value);
+
+    /* Verify post-conditions */
+    if (result >= 0) {
+        __CPROVER_assert((size_t)result == expected_len, "Result is the full output length");
+
+        if (expected_len <= dest.capacity) {
+            __CPROVER_assert(dest.length == expected_len, "Length matches the output");
+        } else {
+            __CPROVER_assert(SSTR_DEFAULT_POLICY != SSTR_ERROR,
+                             "Success on overflow only with TRUNCATE policy");
+            __CPROVER_assert(dest.length == dest.capacity, "Truncated to capacity");
+        }
+
+        /* Output stays within the buffer and is terminated */
+        __CPROVER_assert(dest.length <= dest.capacity, "Length is within capacity");
+        __CPROVER_assert(dest.data[dest.length] == '\0', "String is null-terminated");
+
+        /* Negative values start with a sign */
+        if (value < 0) {
+            __CPROVER_assert(dest.data[0] == '-', "Negative values are signed");
+        }
+    } else {
+        __CPROVER_assert(result == SSTR_ERROR_OVERFLOW, "Only overflow can fail for %d");
+        __CPROVER_assert(SSTR_DEFAULT_POLICY == SSTR_ERROR, "Error returned only with ERROR policy");
+        __CPROVER_assert(expected_len > dest.capacity, "Overflow error implies output too long");
+
+        /* The destination is left unchanged */
+        __CPROVER_assert(dest.length == 0, "Length unchanged on overflow");
+        __CPROVER_assert(dest.data[0] == '\0', "Content unchanged on overflow");
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Asim Ihsan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * SPDX-License-Identifier: MPL-2.0
+ */
+
+/*
+ * CBMC Verification Harness for sstr_to_lower, sstr_to_upper and the sstr_trim functions
+ */
+
+#include "../include/sstr/sstr.h"
+#include "../include/sstr/sstr_config.h"
+
+/* Reference predicates, independent of the library's helpers */
+static int is_space_test(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static char lower_test(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + 32) : c;
+}
+
+static char upper_test(char c) {
+    return (c >= 'a' && c <= 'z') ? (char)(c - 32) : c;
+}
+
+/* CBMC verification harness */
+void sstr_transform_harness() {
+    /* Create a small buffer for the string */
+    const size_t BUFFER_SIZE = 10;
+    char buffer[BUFFER_SIZE];
+    SStr str;
+
+    /* Initialize the string */
+    sstr_init(&str, buffer, BUFFER_SIZE);
+
+    /* Nondeterministic content of a nondeterministic length */
+    char original[BUFFER_SIZE];
+    size_t len;
+    __CPROVER_assume(len < BUFFER_SIZE);
+    for (size_t i = 0; i < len; i++) {
+        buffer[i] = original[i];
+    }
+    buffer[len] = '\0';
+    str.length = len;
+
+    /* Pick the operation under test */
+    int op;
+    __CPROVER_assume(op >= 0 && op <= 4);
+
+    SStrResult result;
+    if (op == 0) {
+        result = sstr_to_lower(&str);
+    } else if (op == 1) {
+        result = sstr_to_upper(&str);
+    } else if (op == 2) {
+        result = sstr_trim_left(&str);
+    } else if (op == 3) {
+        result = sstr_trim_right(&str);
+    } else {
+        result = sstr_trim(&str);
+    }
+
+    __CPROVER_assert(result == SSTR_SUCCESS, "Transform succeeds on a valid string");
+    __CPROVER_assert(str.length <= len, "Length never grows");
+    __CPROVER_assert(str.data[str.length] == '\0', "String is null-terminated after transform");
+
+    if (op <= 1) {
+        /* Case conversion keeps the length and changes only ASCII letters */
+        __CPROVER_assert(str.length == len, "Case conversion keeps the length");
+        for (size_t i = 0; i < len; i++) {
+            char expected = op == 0 ? lower_test(original[i]) : upper_test(original[i]);
+            __CPROVER_assert(str.data[i] == expected, "Character converted correctly");
+        }
+    } else {
+        /* Trimming leaves the slice between the leading and trailing whitespace */
+        size_t start = 0;
+        size_t end = len;
+        if (op != 3) {
+            while (start < len && is_space_test(original[start])) {
+                start++;
+            }
+        }
+        if (op != 2) {
+            while (end > start && is_space_test(original[end - 1])) {
+                end--;
+            }
+        }
+        __CPROVER_assert(str.length == end - start, "Trimmed length is correct");
+        for (size_t i = 0; i < str.length; i++) {
+            __CPROVER_assert(str.data[i] == original[start + i], "Trimmed content is preserved");
+        }
+    }
+
+    /* Test the null pointer error cases */
+    __CPROVER_assert(sstr_to_lower(NULL) == SSTR_ERROR_NULL, "Null SStr pointer returns NULL error");
+    __CPROVER_assert(sstr_trim(NULL) == SSTR_ERROR_NULL, "Null SStr pointer returns NULL error");
+}